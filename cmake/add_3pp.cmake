@@ -34,6 +34,7 @@ find_package(Qt5 COMPONENTS
     3DCore
     3DRender
     3DInput
+    3DLogic
     3DExtras
 	Widgets 
 REQUIRED)
@@ -0,0 +1,6 @@
+option(ENABLE_TRACING "Compile in the TRACE_ZONE and TRACE_COUNTER instrumentation, recorded with --trace <path>" OFF)
+
+if(ENABLE_TRACING)
+  message(STATUS "Tracing compiled in")
+  add_compile_definitions(ENABLE_TRACING)
+endif()
@@ -0,0 +1,59 @@
+#include "BenchReport.hpp"
+
+#include <iostream>
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QThread>
+
+namespace bench
+{
+  QJsonObject toJson(const Summary& summary)
+  {
+    return QJsonObject{{QStringLiteral("count"), static_cast<double>(summary.count)},
+                       {QStringLiteral("min"), summary.min},
+                       {QStringLiteral("mean"), summary.mean},
+                       {QStringLiteral("p50"), summary.p50},
+                       {QStringLiteral("p90"), summary.p90},
+                       {QStringLiteral("p99"), summary.p99},
+                       {QStringLiteral("max"), summary.max}};
+  }
+
+  QJsonArray toJson(const std::vector<double>& samples)
+  {
+    auto array = QJsonArray();
+    for(const auto sample : samples) array.append(sample);
+    return array;
+  }
+
+  QJsonObject reportHeader(const QString& benchmark)
+  {
+    return QJsonObject{
+      {QStringLiteral("benchmark"), benchmark},
+      {QStringLiteral("date"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+      {QStringLiteral("os"), QSysInfo::prettyProductName()},
+      {QStringLiteral("cpu"), QSysInfo::currentCpuArchitecture()},
+      {QStringLiteral("threads"), QThread::idealThreadCount()},
+#ifdef NDEBUG
+      {QStringLiteral("build"), QStringLiteral("release")},
+#else
+      {QStringLiteral("build"), QStringLiteral("debug")},
+#endif
+    };
+  }
+
+  bool writeReport(const QString& path, const QJsonObject& report)
+  {
+    auto file = QFile(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+      std::cerr << "cannot write " << path.toStdString() << ": " << file.errorString().toStdString() << '\n';
+      return false;
+    }
+
+    file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    return true;
+  }
+} // namespace bench
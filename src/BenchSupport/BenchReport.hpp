@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+#include "Summary.hpp"
+
+namespace bench
+{
+  QJsonObject toJson(const Summary& summary);
+  QJsonArray toJson(const std::vector<double>& samples);
+
+  // Fields every report starts with: which benchmark, and the build and machine it ran on.
+  QJsonObject reportHeader(const QString& benchmark);
+
+  // Indented, so reports diff well across runs. Prints why to stderr and returns false if the file cannot be written.
+  bool writeReport(const QString& path, const QJsonObject& report);
+} // namespace bench
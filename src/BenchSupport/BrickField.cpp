@@ -0,0 +1,41 @@
+#include "BrickField.hpp"
+
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+  // 2 x 1 bricks turned either way fit in 2 x 2 world units
+  constexpr auto pitch = 2.0f;
+} // namespace
+
+namespace bench
+{
+  std::shared_ptr<ModelAdapter> makeBrickField(std::size_t count)
+  {
+    const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const auto half = 0.5f * pitch * static_cast<float>(side);
+
+    const auto grid = RuntimeGridPolicy(0.5f, half + pitch, Axis::x | Axis::z);
+    auto model = std::make_shared<ModelAdapter>(model::Model(), grid);
+    for(auto i = std::size_t{0}; i < count; ++i)
+    {
+      const auto x = pitch * static_cast<float>(i % side) - half;
+      const auto z = pitch * static_cast<float>(i / side) - half;
+      [[maybe_unused]] const auto added = model->add({x, 0.36f, z}, i % 2 == 0 ? 0.0f : 90.0f);
+      assert(added);
+    }
+    return model;
+  }
+} // namespace bench
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Brick fields hold every brick")
+{
+  for(const auto count : {std::size_t{1}, std::size_t{7}, std::size_t{1000}})
+  {
+    const auto model = bench::makeBrickField(count);
+    REQUIRE(model->entities().size() == count);
+  }
+}
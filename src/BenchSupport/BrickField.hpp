@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "Program/Glue/ModelAdapter.hpp"
+
+namespace bench
+{
+  // A model holding count bricks in a square field around the origin, in rows along x, every other one turned by a
+  // quarter. The grid is just large enough to hold them, so no brick is clamped onto another one.
+  std::shared_ptr<ModelAdapter> makeBrickField(std::size_t count);
+} // namespace bench
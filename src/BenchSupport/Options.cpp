@@ -0,0 +1,44 @@
+#include "Options.hpp"
+
+#include <QByteArray>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QStringList>
+#include <QtGlobal>
+
+namespace bench
+{
+  std::vector<std::size_t> parseCounts(const QString& list)
+  {
+    auto counts = std::vector<std::size_t>();
+    for(const auto& count : list.split(QLatin1Char(','), Qt::SkipEmptyParts))
+    {
+      auto ok = false;
+      const auto value = count.trimmed().toULongLong(&ok);
+      if(ok && value > 0) counts.push_back(static_cast<std::size_t>(value));
+    }
+    return counts;
+  }
+
+  void preferHeadlessRendering()
+  {
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    if(!qEnvironmentVariableIsSet("LIBGL_ALWAYS_SOFTWARE")) qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+    if(!qEnvironmentVariableIsSet("GALLIUM_DRIVER")) qputenv("GALLIUM_DRIVER", "llvmpipe");
+  }
+
+  QString openGLRenderer()
+  {
+    auto surface = QOffscreenSurface();
+    surface.create();
+
+    auto context = QOpenGLContext();
+    if(!surface.isValid() || !context.create() || !context.makeCurrent(&surface)) return {};
+
+    const auto* renderer = context.functions()->glGetString(GL_RENDERER);
+    const auto name = renderer ? QString::fromLatin1(reinterpret_cast<const char*>(renderer)) : QString();
+    context.doneCurrent();
+    return name;
+  }
+} // namespace bench
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <QString>
+
+namespace bench
+{
+  // "1,1000,10000" to its counts; skips entries that are not positive integers
+  std::vector<std::size_t> parseCounts(const QString& list);
+
+  // Renders offscreen through Mesa's software rasterizer, so benchmarks run on machines without a GPU. Variables
+  // already set in the environment win. Call before creating the application. Qt 5's offscreen platform still gets
+  // its OpenGL through GLX, so a machine without a display needs a virtual one, e.g. run under `xvfb-run -a`.
+  void preferHeadlessRendering();
+
+  // Name of the OpenGL renderer a context gets with the default surface format, or empty if no context can be
+  // created or made current. Call after creating the application.
+  QString openGLRenderer();
+} // namespace bench
@@ -0,0 +1,75 @@
+#include "ProcessStats.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+// after windows.h
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+  double toSeconds(const FILETIME& time)
+  {
+    const auto ticks = (static_cast<unsigned long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    return static_cast<double>(ticks) * 100e-9;
+  }
+#else
+  double cpuSeconds(clockid_t clock)
+  {
+    auto time = timespec();
+    clock_gettime(clock, &time);
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+  }
+#endif
+} // namespace
+
+namespace bench
+{
+#ifdef _WIN32
+  std::size_t peakResidentBytes()
+  {
+    auto counters = PROCESS_MEMORY_COUNTERS();
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+  }
+
+  double processCpuSeconds()
+  {
+    auto creation = FILETIME(), exit = FILETIME(), kernel = FILETIME(), user = FILETIME();
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    return toSeconds(kernel) + toSeconds(user);
+  }
+
+  double threadCpuSeconds()
+  {
+    auto creation = FILETIME(), exit = FILETIME(), kernel = FILETIME(), user = FILETIME();
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    return toSeconds(kernel) + toSeconds(user);
+  }
+#else
+  std::size_t peakResidentBytes()
+  {
+    auto usage = rusage();
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+#endif
+  }
+
+  double processCpuSeconds()
+  {
+    return cpuSeconds(CLOCK_PROCESS_CPUTIME_ID);
+  }
+
+  double threadCpuSeconds()
+  {
+    return cpuSeconds(CLOCK_THREAD_CPUTIME_ID);
+  }
+#endif
+} // namespace bench
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bench
+{
+  // highest resident set size of the process so far
+  std::size_t peakResidentBytes();
+
+  // CPU time used so far by all threads of the process, and by the calling thread alone
+  double processCpuSeconds();
+  double threadCpuSeconds();
+} // namespace bench
@@ -0,0 +1,50 @@
+#include "Summary.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "Statistics/Percentile.hpp"
+
+namespace bench
+{
+  Summary summarize(std::vector<double> samples)
+  {
+    if(samples.empty()) return {};
+
+    std::sort(samples.begin(), samples.end());
+
+    auto summary = Summary();
+    summary.count = samples.size();
+    summary.min = samples.front();
+    summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    summary.p50 = statistics::percentile(samples, 0.5);
+    summary.p90 = statistics::percentile(samples, 0.9);
+    summary.p99 = statistics::percentile(samples, 0.99);
+    summary.max = samples.back();
+    return summary;
+  }
+} // namespace bench
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Sample summaries")
+{
+  REQUIRE(bench::summarize({}).count == 0);
+
+  const auto single = bench::summarize({3.0});
+  REQUIRE(single.min == 3.0);
+  REQUIRE(single.p50 == 3.0);
+  REQUIRE(single.p99 == 3.0);
+  REQUIRE(single.max == 3.0);
+
+  auto samples = std::vector<double>();
+  for(auto i = 100; i >= 1; --i) samples.push_back(static_cast<double>(i));
+  const auto summary = bench::summarize(samples);
+  REQUIRE(summary.count == 100);
+  REQUIRE(summary.min == 1.0);
+  REQUIRE(summary.mean == 50.5);
+  REQUIRE(summary.p50 == 50.0);
+  REQUIRE(summary.p90 == 90.0);
+  REQUIRE(summary.p99 == 99.0);
+  REQUIRE(summary.max == 100.0);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace bench
+{
+  // Distribution of a series of samples. Percentiles use the nearest rank, so they are always one of the samples.
+  struct Summary
+  {
+    std::size_t count{};
+    double min{};
+    double mean{};
+    double p50{};
+    double p90{};
+    double p99{};
+    double max{};
+  };
+
+  // all zero for no samples
+  Summary summarize(std::vector<double> samples);
+} // namespace bench
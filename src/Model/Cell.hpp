@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace model
+{
+  using Slot = std::uint32_t;
+
+  // position on the ground grid, in whole grid cells
+  struct Cell
+  {
+    std::int32_t x{};
+    std::int32_t z{};
+  };
+
+  inline bool operator==(Cell lhs, Cell rhs)
+  {
+    return lhs.x == rhs.x && lhs.z == rhs.z;
+  }
+
+  inline bool operator!=(Cell lhs, Cell rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  // cells from min (inclusive) to max (exclusive)
+  struct CellBox
+  {
+    Cell min;
+    Cell max;
+  };
+
+  inline bool operator==(const CellBox& lhs, const CellBox& rhs)
+  {
+    return lhs.min == rhs.min && lhs.max == rhs.max;
+  }
+
+  inline bool overlaps(const CellBox& lhs, const CellBox& rhs)
+  {
+    return lhs.min.x < rhs.max.x && rhs.min.x < lhs.max.x && lhs.min.z < rhs.max.z && rhs.min.z < lhs.max.z;
+  }
+
+  inline std::int64_t cellCount(const CellBox& box)
+  {
+    const auto xExtent = std::int64_t{box.max.x} - box.min.x;
+    const auto zExtent = std::int64_t{box.max.z} - box.min.z;
+    return xExtent > 0 && zExtent > 0 ? xExtent * zExtent : 0;
+  }
+
+  template<typename Function>
+  void forEachCell(const CellBox& box, Function function)
+  {
+    for(auto x = box.min.x; x < box.max.x; ++x)
+    {
+      for(auto z = box.min.z; z < box.max.z; ++z)
+      {
+        function(Cell{x, z});
+      }
+    }
+  }
+} // namespace model
@@ -0,0 +1,108 @@
+#include "ChunkIndex.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+  // rounds towards negative infinity, so that cell -1 lies in chunk -1
+  std::int32_t floorDivide(std::int32_t value, std::int32_t divisor)
+  {
+    const auto quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+  }
+} // namespace
+
+namespace model
+{
+  Chunk ChunkIndex::chunkOf(Cell cell)
+  {
+    return {floorDivide(cell.x, chunkSize), floorDivide(cell.z, chunkSize)};
+  }
+
+  CellBox ChunkIndex::cellsOf(Chunk chunk)
+  {
+    const auto min = Cell{chunk.x * chunkSize, chunk.z * chunkSize};
+    return {min, {min.x + chunkSize, min.z + chunkSize}};
+  }
+
+  void ChunkIndex::insert(Slot slot, Cell cell)
+  {
+    slots_[keyOf(chunkOf(cell))].push_back(slot);
+  }
+
+  void ChunkIndex::erase(Slot slot, Cell cell)
+  {
+    const auto found = slots_.find(keyOf(chunkOf(cell)));
+    assert(found != slots_.end());
+
+    auto& slots = found->second;
+    const auto position = std::find(slots.begin(), slots.end(), slot);
+    assert(position != slots.end());
+
+    *position = slots.back();
+    slots.pop_back();
+    if(slots.empty()) slots_.erase(found);
+  }
+
+  void ChunkIndex::move(Slot slot, Cell from, Cell to)
+  {
+    if(chunkOf(from) == chunkOf(to)) return;
+
+    erase(slot, from);
+    insert(slot, to);
+  }
+
+  std::vector<Chunk> ChunkIndex::chunks() const
+  {
+    auto chunks = std::vector<Chunk>();
+    chunks.reserve(slots_.size());
+    for(const auto& entry : slots_)
+    {
+      chunks.push_back({static_cast<std::int32_t>(entry.first >> 32), static_cast<std::int32_t>(entry.first)});
+    }
+    return chunks;
+  }
+
+  const std::vector<Slot>& ChunkIndex::slotsIn(Chunk chunk) const
+  {
+    static const auto none = std::vector<Slot>();
+
+    const auto found = slots_.find(keyOf(chunk));
+    return found == slots_.end() ? none : found->second;
+  }
+
+  std::uint64_t ChunkIndex::keyOf(Chunk chunk)
+  {
+    return (std::uint64_t{static_cast<std::uint32_t>(chunk.x)} << 32) | static_cast<std::uint32_t>(chunk.z);
+  }
+} // namespace model
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("ChunkIndex")
+{
+  REQUIRE(model::ChunkIndex::chunkOf({0, 15}) == model::Chunk{0, 0});
+  REQUIRE(model::ChunkIndex::chunkOf({16, -1}) == model::Chunk{1, -1});
+  REQUIRE(model::ChunkIndex::chunkOf({-16, -17}) == model::Chunk{-1, -2});
+  REQUIRE(model::ChunkIndex::cellsOf({-1, 2}) == model::CellBox{{-16, 32}, {0, 48}});
+
+  auto index = model::ChunkIndex();
+  index.insert(1, {0, 0});
+  index.insert(2, {3, 3});
+  index.insert(3, {-3, 3});
+  REQUIRE(index.chunks().size() == 2);
+  REQUIRE(index.slotsIn({0, 0}).size() == 2);
+  REQUIRE(index.slotsIn({-1, 0}) == std::vector<model::Slot>{3});
+  REQUIRE(index.slotsIn({5, 5}).empty());
+
+  index.move(1, {0, 0}, {1, 1});
+  REQUIRE(index.slotsIn({0, 0}).size() == 2);
+
+  index.move(1, {1, 1}, {-1, 1});
+  REQUIRE(index.slotsIn({0, 0}) == std::vector<model::Slot>{2});
+  REQUIRE(index.slotsIn({-1, 0}).size() == 2);
+
+  index.erase(2, {3, 3});
+  REQUIRE(index.chunks() == std::vector<model::Chunk>{{-1, 0}});
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Cell.hpp"
+
+namespace model
+{
+  // square block of chunkSize x chunkSize cells
+  struct Chunk
+  {
+    std::int32_t x{};
+    std::int32_t z{};
+  };
+
+  inline bool operator==(Chunk lhs, Chunk rhs)
+  {
+    return lhs.x == rhs.x && lhs.z == rhs.z;
+  }
+
+  // Groups bricks by the chunk their cell lies in, so whole regions can be visited or skipped at once.
+  class ChunkIndex
+  {
+  public:
+    constexpr static std::int32_t chunkSize = 16;
+
+    static Chunk chunkOf(Cell cell);
+    static CellBox cellsOf(Chunk chunk);
+
+    void insert(Slot slot, Cell cell);
+    void erase(Slot slot, Cell cell);
+    void move(Slot slot, Cell from, Cell to);
+
+    // chunks holding at least one brick, in no particular order
+    std::vector<Chunk> chunks() const;
+    // bricks whose cell lies in the chunk, in no particular order
+    const std::vector<Slot>& slotsIn(Chunk chunk) const;
+
+  private:
+    static std::uint64_t keyOf(Chunk chunk);
+
+    std::unordered_map<std::uint64_t, std::vector<Slot>> slots_;
+  };
+} // namespace model
@@ -1 +1,784 @@
-#include "Model.hpp"
\ No newline at end of file
+#include "Model.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace
+{
+  // narrows [tMin, tMax] to the part of the ray with min <= origin + t * direction <= max
+  bool clipToSlab(float origin, float direction, float min, float max, float& tMin, float& tMax)
+  {
+    if(std::fpclassify(direction) == FP_ZERO) return origin >= min && origin <= max;
+
+    const auto tMinSide = (min - origin) / direction;
+    const auto tMaxSide = (max - origin) / direction;
+    tMin = std::max(tMin, std::min(tMinSide, tMaxSide));
+    tMax = std::min(tMax, std::max(tMinSide, tMaxSide));
+    return tMin <= tMax;
+  }
+
+  // one axis of the cell walk: the cell index, and the distance at which the ray crosses into the next cell
+  struct CellStep
+  {
+    std::int32_t cell{};
+    std::int32_t step{};
+    float next{};
+    float delta{};
+  };
+
+  CellStep firstStep(float origin, float direction, float t)
+  {
+    const auto cell = static_cast<std::int32_t>(std::floor(origin + t * direction));
+    if(std::fpclassify(direction) == FP_ZERO)
+    {
+      return {cell, 0, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+    }
+
+    const auto step = direction > 0.0f ? 1 : -1;
+    const auto boundary = static_cast<float>(direction > 0.0f ? cell + 1 : cell);
+    return {cell, step, (boundary - origin) / direction, 1.0f / std::abs(direction)};
+  }
+
+  // what a slot has undergone in total, given what it underwent so far and what happened next
+  model::ChangeKind combined(model::ChangeKind pending, model::ChangeKind next)
+  {
+    using model::ChangeKind;
+    switch(pending)
+    {
+    case ChangeKind::None: return next;
+    case ChangeKind::Inserted: return next == ChangeKind::Removed ? ChangeKind::None : ChangeKind::Inserted;
+    case ChangeKind::Updated: return next == ChangeKind::Removed ? ChangeKind::Removed : ChangeKind::Updated;
+    case ChangeKind::Removed: return next == ChangeKind::Inserted ? ChangeKind::Updated : ChangeKind::Removed;
+    }
+    return next;
+  }
+} // namespace
+
+namespace model
+{
+  QuarterTurn rotatedByQuarter(QuarterTurn rotation)
+  {
+    return static_cast<QuarterTurn>((static_cast<std::uint8_t>(rotation) + 1) % 4);
+  }
+
+  CellBox footprintOf(Cell cell, QuarterTurn rotation, BrickShape shape)
+  {
+    const auto turned = rotation == QuarterTurn::Deg90 || rotation == QuarterTurn::Deg270;
+    const auto xExtent = turned ? shape.width : shape.length;
+    const auto zExtent = turned ? shape.length : shape.width;
+
+    const auto min = Cell{cell.x - xExtent / 2, cell.z - zExtent / 2};
+    return {min, {min.x + xExtent, min.z + zExtent}};
+  }
+
+  std::optional<Slot> Model::add(Cell cell, QuarterTurn rotation, BrickType type)
+  {
+    assert(isValidCell(cell));
+
+    const auto footprint = model::footprintOf(cell, rotation, shape(type));
+    if(!occupancy_.isFree(footprint, noSlot)) return std::nullopt;
+
+    auto state = State{static_cast<std::uint8_t>(rotation), static_cast<std::uint8_t>(type), 1, 0};
+
+    auto slot = static_cast<Slot>(cells_.size());
+    if(!freeSlots_.empty())
+    {
+      slot = freeSlots_.back();
+      freeSlots_.pop_back();
+
+      // the removal of the previous brick may still be pending
+      state.change = states_[slot].change;
+      cells_[slot] = cell;
+      states_[slot] = state;
+    }
+    else
+    {
+      cells_.push_back(cell);
+      states_.push_back(state);
+    }
+
+    occupancy_.occupy(footprint, slot);
+    chunks_.insert(slot, cell);
+    record(slot, ChangeKind::Inserted);
+    return slot;
+  }
+
+  void Model::reserve(std::size_t bricks, BrickType type)
+  {
+    cells_.reserve(bricks);
+    states_.reserve(bricks);
+    changed_.reserve(bricks);
+
+    const auto brickShape = shape(type);
+    occupancy_.reserve(bricks * static_cast<std::size_t>(brickShape.length * brickShape.width));
+  }
+
+  void Model::remove(Slot slot)
+  {
+    assert(contains(slot));
+
+    occupancy_.release(footprint(slot), slot);
+    chunks_.erase(slot, cells_[slot]);
+    states_[slot].alive = 0;
+    freeSlots_.push_back(slot);
+    record(slot, ChangeKind::Removed);
+  }
+
+  bool Model::contains(Slot slot) const
+  {
+    return slot < states_.size() && states_[slot].alive;
+  }
+
+  std::size_t Model::size() const
+  {
+    return states_.size() - freeSlots_.size();
+  }
+
+  std::size_t Model::slotCount() const
+  {
+    return states_.size();
+  }
+
+  Cell Model::cell(Slot slot) const
+  {
+    return cells_[slot];
+  }
+
+  QuarterTurn Model::rotation(Slot slot) const
+  {
+    return static_cast<QuarterTurn>(states_[slot].quarterTurns);
+  }
+
+  BrickType Model::type(Slot slot) const
+  {
+    return static_cast<BrickType>(states_[slot].type);
+  }
+
+  bool Model::moveTo(Slot slot, Cell cell)
+  {
+    assert(contains(slot));
+    return place(slot, cell, rotation(slot));
+  }
+
+  bool Model::rotateTo(Slot slot, QuarterTurn rotation)
+  {
+    assert(contains(slot));
+    return place(slot, cell(slot), rotation);
+  }
+
+  bool Model::moveMany(const std::vector<Slot>& slots, const std::vector<Cell>& cells)
+  {
+    assert(slots.size() == cells.size());
+
+    return relocate(slots, [this, &slots, &cells](std::size_t i) {
+      return std::pair(cells[i], rotation(slots[i]));
+    });
+  }
+
+  bool Model::rotateMany(const std::vector<Slot>& slots)
+  {
+    return relocate(slots, [this, &slots](std::size_t i) {
+      return std::pair(cell(slots[i]), rotatedByQuarter(rotation(slots[i])));
+    });
+  }
+
+  std::optional<Slot> Model::occupant(Cell cell) const
+  {
+    return occupancy_.at(cell);
+  }
+
+  CellBox Model::footprint(Slot slot) const
+  {
+    return model::footprintOf(cells_[slot], rotation(slot), shape(type(slot)));
+  }
+
+  std::vector<Slot> Model::overlapping(const CellBox& box) const
+  {
+    auto slots = std::vector<Slot>();
+    appendOverlapping(box, slots);
+    return slots;
+  }
+
+  std::vector<Overlap> Model::overlapping(const std::vector<CellBox>& boxes) const
+  {
+    auto overlaps = std::vector<Overlap>();
+    auto slots = std::vector<Slot>();
+    for(auto query = std::size_t{0}; query < boxes.size(); ++query)
+    {
+      slots.clear();
+      appendOverlapping(boxes[query], slots);
+      for(const auto slot : slots) overlaps.push_back({query, slot});
+    }
+    return overlaps;
+  }
+
+  const ChunkIndex& Model::chunks() const
+  {
+    return chunks_;
+  }
+
+  CellBox Model::chunkBounds(Chunk chunk) const
+  {
+    // a brick reaches at most half its longer side (rounded up) from its cell, whichever way it is turned
+    const auto shape = brick2x1Shape_;
+    const auto reach = (std::max(shape.length, shape.width) + 1) / 2;
+
+    auto bounds = ChunkIndex::cellsOf(chunk);
+    bounds.min = {bounds.min.x - reach, bounds.min.z - reach};
+    bounds.max = {bounds.max.x + reach, bounds.max.z + reach};
+    return bounds;
+  }
+
+  std::vector<Change> Model::takeChanges()
+  {
+    auto changes = std::vector<Change>();
+    changes.reserve(changed_.size());
+
+    for(const auto slot : changed_)
+    {
+      const auto kind = static_cast<ChangeKind>(states_[slot].change);
+      if(kind == ChangeKind::None) continue;
+
+      changes.push_back({slot, kind});
+      states_[slot].change = static_cast<std::uint8_t>(ChangeKind::None);
+    }
+
+    changed_.clear();
+    return changes;
+  }
+
+  bool Model::hasChanges() const
+  {
+    return !changed_.empty();
+  }
+
+  std::optional<Hit> Model::pick(const Ray& ray, float height) const
+  {
+    const auto& bounds = occupancy_.bounds();
+    if(cellCount(bounds) == 0) return std::nullopt;
+
+    // a ray without a direction never leaves the bounds, and one with a NaN in it never ends the walk
+    const auto& [origin, direction] = ray;
+    const auto finite = [](const std::array<float, 3>& v) {
+      return std::all_of(v.begin(), v.end(), [](float value) { return std::isfinite(value); });
+    };
+    const auto moves = std::any_of(direction.begin(), direction.end(), [](float value) { return std::abs(value) > 0.0f; });
+    if(!finite(origin) || !finite(direction) || !moves) return std::nullopt;
+
+    auto tMin = 0.0f;
+    auto tMax = std::numeric_limits<float>::infinity();
+    const auto lower = std::array<float, 3>{static_cast<float>(bounds.min.x), 0.0f, static_cast<float>(bounds.min.z)};
+    const auto upper = std::array<float, 3>{static_cast<float>(bounds.max.x), height, static_cast<float>(bounds.max.z)};
+    for(auto axis = std::size_t{0}; axis < 3; ++axis)
+    {
+      if(!clipToSlab(origin[axis], direction[axis], lower[axis], upper[axis], tMin, tMax)) return std::nullopt;
+    }
+
+    auto x = firstStep(origin[0], direction[0], tMin);
+    auto z = firstStep(origin[2], direction[2], tMin);
+    for(auto t = tMin; t <= tMax;)
+    {
+      if(const auto slot = occupancy_.at({x.cell, z.cell})) return Hit{*slot, t};
+
+      auto& axis = x.next < z.next ? x : z;
+      t = axis.next;
+      axis.cell += axis.step;
+      axis.next += axis.delta;
+    }
+
+    return std::nullopt;
+  }
+
+  void Model::setShape(BrickType type, BrickShape shape)
+  {
+    assert(size() == 0);
+    assert(type == BrickType::Brick2x1);
+    assert(isValidShape(shape));
+
+    brick2x1Shape_ = shape;
+  }
+
+  BrickShape Model::shape(BrickType /*type*/) const
+  {
+    return brick2x1Shape_;
+  }
+
+  const std::vector<Cell>& Model::cells() const
+  {
+    return cells_;
+  }
+
+  bool Model::place(Slot slot, Cell cell, QuarterTurn rotation)
+  {
+    assert(contains(slot));
+    assert(isValidCell(cell));
+
+    const auto placed = model::footprintOf(cell, rotation, shape(type(slot)));
+    if(!occupancy_.isFree(placed, slot)) return false;
+
+    occupancy_.release(footprint(slot), slot);
+    occupancy_.occupy(placed, slot);
+    chunks_.move(slot, cells_[slot], cell);
+
+    cells_[slot] = cell;
+    states_[slot].quarterTurns = static_cast<std::uint8_t>(rotation);
+    record(slot, ChangeKind::Updated);
+    return true;
+  }
+
+  void Model::record(Slot slot, ChangeKind kind)
+  {
+    const auto pending = static_cast<ChangeKind>(states_[slot].change);
+    if(pending == ChangeKind::None) changed_.push_back(slot);
+
+    states_[slot].change = static_cast<std::uint8_t>(combined(pending, kind));
+  }
+
+  void Model::appendOverlapping(const CellBox& box, std::vector<Slot>& slots) const
+  {
+    const auto first = slots.size();
+
+    // A hash probe costs about as much as computing and testing a handful of footprints, so large boxes are cheaper
+    // to answer by streaming through the cell and state columns.
+    constexpr auto scansPerProbe = std::int64_t{8};
+    if(cellCount(box) * scansPerProbe <= static_cast<std::int64_t>(slotCount()))
+    {
+      forEachCell(box, [this, &slots](Cell cell) {
+        if(const auto slot = occupancy_.at(cell)) slots.push_back(*slot);
+      });
+    }
+    else
+    {
+      for(auto slot = Slot{0}; slot < slotCount(); ++slot)
+      {
+        if(contains(slot) && overlaps(footprint(slot), box)) slots.push_back(slot);
+      }
+    }
+
+    std::sort(slots.begin() + static_cast<std::ptrdiff_t>(first), slots.end());
+    slots.erase(std::unique(slots.begin() + static_cast<std::ptrdiff_t>(first), slots.end()), slots.end());
+  }
+
+  template<typename NewPlacement>
+  bool Model::relocate(const std::vector<Slot>& slots, NewPlacement newPlacement)
+  {
+    auto sorted = slots;
+    std::sort(sorted.begin(), sorted.end());
+    if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return false;
+
+    for(const auto slot : slots)
+    {
+      assert(contains(slot));
+      occupancy_.release(footprint(slot), slot);
+    }
+
+    auto placed = std::vector<CellBox>();
+    placed.reserve(slots.size());
+    for(auto i = std::size_t{0}; i < slots.size(); ++i)
+    {
+      const auto [cell, rotation] = newPlacement(i);
+      const auto box = model::footprintOf(cell, rotation, shape(type(slots[i])));
+
+      if(!occupancy_.isFree(box, noSlot))
+      {
+        for(auto j = std::size_t{0}; j < placed.size(); ++j) occupancy_.release(placed[j], slots[j]);
+        for(const auto slot : slots) occupancy_.occupy(footprint(slot), slot);
+        return false;
+      }
+
+      occupancy_.occupy(box, slots[i]);
+      placed.push_back(box);
+    }
+
+    for(auto i = std::size_t{0}; i < slots.size(); ++i)
+    {
+      const auto [cell, rotation] = newPlacement(i);
+      chunks_.move(slots[i], cells_[slots[i]], cell);
+      cells_[slots[i]] = cell;
+      states_[slots[i]].quarterTurns = static_cast<std::uint8_t>(rotation);
+      record(slots[i], ChangeKind::Updated);
+    }
+    return true;
+  }
+} // namespace model
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Model slots")
+{
+  auto model = model::Model();
+
+  const auto first = *model.add({1, 2}, model::QuarterTurn::Deg90);
+  const auto second = *model.add({10, 4}, model::QuarterTurn::Deg0);
+  REQUIRE(first == 0);
+  REQUIRE(second == 1);
+  REQUIRE(model.size() == 2);
+  REQUIRE(model.cells()[second] == model::Cell{10, 4});
+  REQUIRE(model.rotation(first) == model::QuarterTurn::Deg90);
+  REQUIRE(model.type(first) == model::BrickType::Brick2x1);
+
+  model.remove(first);
+  REQUIRE(!model.contains(first));
+  REQUIRE(model.contains(second));
+  REQUIRE(model.size() == 1);
+  REQUIRE(model.slotCount() == 2);
+
+  const auto reused = *model.add({5, -6}, model::QuarterTurn::Deg180);
+  REQUIRE(reused == first);
+  REQUIRE(model.contains(reused));
+  REQUIRE(model.cell(reused) == model::Cell{5, -6});
+  REQUIRE(model.rotation(reused) == model::QuarterTurn::Deg180);
+  REQUIRE(model.slotCount() == 2);
+}
+
+TEST_CASE("Footprints follow the rotation")
+{
+  const auto shape = model::BrickShape{4, 2};
+  REQUIRE(model::footprintOf({0, 0}, model::QuarterTurn::Deg0, shape) == model::CellBox{{-2, -1}, {2, 1}});
+  REQUIRE(model::footprintOf({0, 0}, model::QuarterTurn::Deg90, shape) == model::CellBox{{-1, -2}, {1, 2}});
+  REQUIRE(model::footprintOf({3, 5}, model::QuarterTurn::Deg180, shape) == model::CellBox{{1, 4}, {5, 6}});
+}
+
+TEST_CASE("Bricks never overlap")
+{
+  auto model = model::Model();
+
+  const auto first = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  REQUIRE(model.occupant({-2, -1}) == first);
+  REQUIRE(model.occupant({1, 0}) == first);
+  REQUIRE(!model.occupant({2, 0}));
+
+  REQUIRE(!model.add({3, 0}, model::QuarterTurn::Deg0));
+  const auto second = *model.add({4, 0}, model::QuarterTurn::Deg0);
+
+  SUBCASE("moving into another brick is rejected")
+  {
+    REQUIRE(!model.moveTo(second, {2, 1}));
+    REQUIRE(model.cell(second) == model::Cell{4, 0});
+    REQUIRE(model.moveTo(second, {4, 2}));
+    REQUIRE(model.occupant({4, 1}) == second);
+    REQUIRE(!model.occupant({4, 0}));
+  }
+
+  SUBCASE("rotating into another brick is rejected")
+  {
+    REQUIRE(model.moveTo(second, {1, 2}));
+    REQUIRE(!model.rotateTo(second, model::QuarterTurn::Deg90));
+    REQUIRE(model.rotation(second) == model::QuarterTurn::Deg0);
+
+    REQUIRE(model.moveTo(second, {10, 10}));
+    REQUIRE(model.rotateTo(first, model::QuarterTurn::Deg90));
+    REQUIRE(model.occupant({0, -2}) == first);
+    REQUIRE(!model.occupant({-2, 0}));
+  }
+
+  SUBCASE("moving onto the own footprint is allowed")
+  {
+    REQUIRE(model.moveTo(first, {-1, 0}));
+  }
+
+  SUBCASE("removing frees the cells")
+  {
+    model.remove(first);
+    REQUIRE(!model.occupant({0, 0}));
+    REQUIRE(model.add({-1, 0}, model::QuarterTurn::Deg0));
+  }
+}
+
+TEST_CASE("Batch moves are all or nothing")
+{
+  auto model = model::Model();
+  const auto first = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  const auto second = *model.add({4, 0}, model::QuarterTurn::Deg0);
+  const auto blocker = *model.add({0, 6}, model::QuarterTurn::Deg0);
+
+  // the second brick moves into the cells the first one leaves
+  REQUIRE(model.moveMany({first, second}, {{4, 0}, {8, 0}}));
+  REQUIRE(model.occupant({3, 0}) == first);
+  REQUIRE(model.occupant({7, 0}) == second);
+
+  REQUIRE(!model.moveMany({first, second}, {{4, 2}, {0, 5}}));
+  REQUIRE(model.cell(first) == model::Cell{4, 0});
+  REQUIRE(model.cell(second) == model::Cell{8, 0});
+  REQUIRE(model.occupant({3, 0}) == first);
+  REQUIRE(model.occupant({0, 6}) == blocker);
+  REQUIRE(!model.occupant({4, 2}));
+
+  REQUIRE(!model.moveMany({first, first}, {{20, 0}, {30, 0}}));
+  REQUIRE(model.occupant({3, 0}) == first);
+
+  REQUIRE(model.rotateMany({first, second}));
+  REQUIRE(model.rotation(second) == model::QuarterTurn::Deg90);
+}
+
+TEST_CASE("Footprints follow moves and rotations")
+{
+  auto model = model::Model();
+  const auto slot = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  REQUIRE(model.footprint(slot) == model::CellBox{{-2, -1}, {2, 1}});
+
+  REQUIRE(model.rotateTo(slot, model::QuarterTurn::Deg90));
+  REQUIRE(model.footprint(slot) == model::CellBox{{-1, -2}, {1, 2}});
+
+  REQUIRE(model.moveTo(slot, {10, 0}));
+  REQUIRE(model.footprint(slot) == model::CellBox{{9, -2}, {11, 2}});
+
+  REQUIRE(model.moveMany({slot}, {{20, 20}}));
+  REQUIRE(model.footprint(slot) == model::CellBox{{19, 18}, {21, 22}});
+}
+
+TEST_CASE("Overlap queries")
+{
+  auto model = model::Model();
+  auto slots = std::vector<model::Slot>();
+  for(auto i = 0; i < 40; ++i)
+  {
+    slots.push_back(*model.add({i * 4, 0}, model::QuarterTurn::Deg0));
+  }
+  model.remove(slots[2]);
+
+  // small boxes probe the occupancy index, large ones scan the footprints; both must agree
+  REQUIRE(model.overlapping(model::CellBox{{1, 0}, {3, 1}}) == std::vector<model::Slot>{slots[0], slots[1]});
+  REQUIRE(model.overlapping(model::CellBox{{5, -5}, {13, 5}}) == std::vector<model::Slot>{slots[1], slots[3]});
+  REQUIRE(model.overlapping(model::CellBox{{-100, -100}, {11, 100}}) ==
+          std::vector<model::Slot>{slots[0], slots[1], slots[3]});
+  REQUIRE(model.overlapping(model::CellBox{{0, 1}, {100, 100}}).empty());
+  REQUIRE(model.overlapping(model::CellBox{{5, 5}, {0, 0}}).empty());
+
+  const auto overlaps =
+    model.overlapping(std::vector<model::CellBox>{{{0, 0}, {1, 1}}, {{0, 5}, {1, 6}}, {{13, 0}, {14, 1}}});
+  REQUIRE(overlaps.size() == 2);
+  REQUIRE(overlaps[0].query == 0);
+  REQUIRE(overlaps[0].slot == slots[0]);
+  REQUIRE(overlaps[1].query == 2);
+  REQUIRE(overlaps[1].slot == slots[3]);
+}
+
+TEST_CASE("Changes are coalesced until taken")
+{
+  using model::ChangeKind;
+  using Changes = std::vector<model::Change>;
+
+  auto model = model::Model();
+  const auto first = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  const auto second = *model.add({10, 0}, model::QuarterTurn::Deg0);
+  REQUIRE(model.moveTo(second, {11, 0}));
+  REQUIRE(model.hasChanges());
+  REQUIRE(model.takeChanges() == Changes{{first, ChangeKind::Inserted}, {second, ChangeKind::Inserted}});
+  REQUIRE(!model.hasChanges());
+  REQUIRE(model.takeChanges().empty());
+
+  for(auto x = 1; x < 5; ++x) REQUIRE(model.moveTo(second, {10 + x, 0}));
+  REQUIRE(model.rotateTo(second, model::QuarterTurn::Deg90));
+  REQUIRE(!model.moveTo(first, {13, 0}));
+  REQUIRE(model.takeChanges() == Changes{{second, ChangeKind::Updated}});
+
+  REQUIRE(model.moveMany({first, second}, {{0, 5}, {10, 5}}));
+  model.remove(second);
+  REQUIRE(model.takeChanges() == Changes{{first, ChangeKind::Updated}, {second, ChangeKind::Removed}});
+
+  // the slot is reused by a new brick before anyone saw the removal
+  model.remove(first);
+  REQUIRE(model.add({0, 0}, model::QuarterTurn::Deg0) == first);
+  REQUIRE(model.takeChanges() == Changes{{first, ChangeKind::Updated}});
+
+  // a brick that comes and goes between two flushes is never reported, even if its slot is reused again
+  const auto transient = *model.add({20, 20}, model::QuarterTurn::Deg0);
+  model.remove(transient);
+  REQUIRE(model.takeChanges().empty());
+
+  REQUIRE(model.add({20, 20}, model::QuarterTurn::Deg0) == transient);
+  model.remove(transient);
+  REQUIRE(model.add({30, 30}, model::QuarterTurn::Deg0) == transient);
+  REQUIRE(model.takeChanges() == Changes{{transient, ChangeKind::Inserted}});
+}
+
+TEST_CASE("Change kinds combine")
+{
+  using model::ChangeKind;
+  using Changes = std::vector<model::Change>;
+
+  auto model = model::Model();
+  const auto brick = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  REQUIRE(model.moveTo(brick, {1, 0}));
+  REQUIRE(model.takeChanges() == Changes{{brick, ChangeKind::Inserted}});
+
+  REQUIRE(model.moveTo(brick, {2, 0}));
+  REQUIRE(model.takeChanges() == Changes{{brick, ChangeKind::Updated}});
+
+  REQUIRE(model.rotateTo(brick, model::QuarterTurn::Deg90));
+  model.remove(brick);
+  REQUIRE(model.takeChanges() == Changes{{brick, ChangeKind::Removed}});
+
+  const auto reused = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  REQUIRE(model.takeChanges() == Changes{{reused, ChangeKind::Inserted}});
+  model.remove(reused);
+  REQUIRE(model.add({5, 5}, model::QuarterTurn::Deg0) == reused);
+  REQUIRE(model.takeChanges() == Changes{{reused, ChangeKind::Updated}});
+
+  model.remove(reused);
+  REQUIRE(model.add({5, 5}, model::QuarterTurn::Deg0) == reused);
+  model.remove(reused);
+  REQUIRE(model.takeChanges() == Changes{{reused, ChangeKind::Removed}});
+}
+
+TEST_CASE("Picking finds the nearest brick along a ray")
+{
+  auto model = model::Model();
+  REQUIRE(!model.pick({{0.0f, 5.0f, 0.0f}, {0.0f, -1.0f, 0.0f}}, 1.0f));
+
+  const auto near = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  const auto far = *model.add({10, 0}, model::QuarterTurn::Deg90);
+
+  SUBCASE("Straight down onto the top face")
+  {
+    const auto hit = model.pick({{1.5f, 5.0f, 0.5f}, {0.0f, -1.0f, 0.0f}}, 1.0f);
+    REQUIRE(hit);
+    REQUIRE(hit->slot == near);
+    REQUIRE(hit->distance == 4.0f);
+
+    REQUIRE(!model.pick({{2.5f, 5.0f, 0.5f}, {0.0f, -1.0f, 0.0f}}, 1.0f));
+  }
+
+  SUBCASE("Along the ground, the first brick shadows the second")
+  {
+    const auto hit = model.pick({{-20.0f, 0.5f, 0.5f}, {1.0f, 0.0f, 0.0f}}, 1.0f);
+    REQUIRE(hit);
+    REQUIRE(hit->slot == near);
+    REQUIRE(hit->distance == 18.0f);
+
+    const auto fromBehind = model.pick({{30.0f, 0.5f, 0.5f}, {-1.0f, 0.0f, 0.0f}}, 1.0f);
+    REQUIRE(fromBehind);
+    REQUIRE(fromBehind->slot == far);
+    REQUIRE(fromBehind->distance == 19.0f);
+  }
+
+  SUBCASE("Oblique rays enter through the side faces")
+  {
+    const auto hit = model.pick({{6.5f, 3.0f, 0.5f}, {1.0f, -1.0f, 0.0f}}, 1.0f);
+    REQUIRE(hit);
+    REQUIRE(hit->slot == far);
+    REQUIRE(hit->distance == 2.5f);
+
+    REQUIRE(!model.pick({{6.5f, 3.0f, 0.5f}, {0.5f, -1.0f, 0.0f}}, 1.0f));
+    REQUIRE(!model.pick({{6.5f, 3.0f, 0.5f}, {1.0f, 1.0f, 0.0f}}, 1.0f));
+  }
+
+  SUBCASE("Removed bricks are not hit")
+  {
+    model.remove(near);
+    REQUIRE(!model.pick({{1.5f, 5.0f, 0.5f}, {0.0f, -1.0f, 0.0f}}, 1.0f));
+    REQUIRE(model.pick({{-20.0f, 0.5f, 0.5f}, {1.0f, 0.0f, 0.0f}}, 1.0f)->slot == far);
+  }
+}
+
+TEST_CASE("Picking rejects rays that go nowhere")
+{
+  auto model = model::Model();
+  REQUIRE(model.add({6, 0}, model::QuarterTurn::Deg0));
+
+  // the origin lies inside the bricks' bounds, where a walk along a zero direction would never end
+  REQUIRE(!model.pick({{7.0f, 0.5f, 0.5f}, {0.0f, 0.0f, 0.0f}}, 1.0f));
+
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  const auto infinity = std::numeric_limits<float>::infinity();
+  REQUIRE(!model.pick({{7.0f, 0.5f, 0.5f}, {nan, 0.0f, 0.0f}}, 1.0f));
+  REQUIRE(!model.pick({{7.0f, 0.5f, 0.5f}, {infinity, 0.0f, 0.0f}}, 1.0f));
+  REQUIRE(!model.pick({{nan, 0.5f, 0.5f}, {1.0f, 0.0f, 0.0f}}, 1.0f));
+
+  REQUIRE(model.pick({{7.0f, 5.0f, 0.5f}, {0.0f, -1.0f, 0.0f}}, 1.0f));
+}
+
+TEST_CASE("Picking matches a brute force search on a dense field")
+{
+  auto model = model::Model();
+  for(auto x = -20; x <= 20; x += 5)
+  {
+    for(auto z = -20; z <= 20; z += 5)
+    {
+      model.add({x, z}, (x + z) % 2 == 0 ? model::QuarterTurn::Deg0 : model::QuarterTurn::Deg90);
+    }
+  }
+
+  auto state = std::uint32_t{7};
+  const auto random = [&state](float range) {
+    state = state * 1664525u + 1013904223u;
+    return (static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f) * range;
+  };
+
+  constexpr auto height = 2.0f;
+  for(auto i = 0; i < 500; ++i)
+  {
+    const auto ray = model::Ray{{random(30.0f), 2.0f + std::abs(random(10.0f)), random(30.0f)},
+                                {random(1.0f), -0.1f - std::abs(random(1.0f)), random(1.0f)}};
+
+    // nearest entry into any footprint box, via the slab test on every brick
+    auto expected = std::optional<model::Hit>();
+    for(auto slot = model::Slot{0}; slot < model.slotCount(); ++slot)
+    {
+      const auto box = model.footprint(slot);
+      const auto lower = std::array<float, 3>{static_cast<float>(box.min.x), 0.0f, static_cast<float>(box.min.z)};
+      const auto upper = std::array<float, 3>{static_cast<float>(box.max.x), height, static_cast<float>(box.max.z)};
+
+      auto tMin = 0.0f;
+      auto tMax = std::numeric_limits<float>::infinity();
+      auto hit = true;
+      for(auto axis = std::size_t{0}; axis < 3; ++axis)
+      {
+        hit = hit && clipToSlab(ray.origin[axis], ray.direction[axis], lower[axis], upper[axis], tMin, tMax);
+      }
+      if(hit && (!expected || tMin < expected->distance)) expected = model::Hit{slot, tMin};
+    }
+
+    const auto picked = model.pick(ray, height);
+    REQUIRE(picked.has_value() == expected.has_value());
+    if(!picked) continue;
+    REQUIRE(std::abs(picked->distance - expected->distance) < 1e-3f);
+    REQUIRE((picked->slot == expected->slot || std::abs(picked->distance - expected->distance) < 1e-5f));
+  }
+}
+
+TEST_CASE("Chunks follow the bricks")
+{
+  auto model = model::Model();
+  const auto first = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  const auto second = *model.add({20, 0}, model::QuarterTurn::Deg0);
+  REQUIRE(model.chunks().slotsIn({0, 0}) == std::vector<model::Slot>{first});
+  REQUIRE(model.chunks().slotsIn({1, 0}) == std::vector<model::Slot>{second});
+
+  REQUIRE(model.moveTo(first, {-1, 0}));
+  REQUIRE(model.chunks().slotsIn({-1, 0}) == std::vector<model::Slot>{first});
+  REQUIRE(model.chunks().slotsIn({0, 0}).empty());
+
+  REQUIRE(model.moveMany({first, second}, {{5, 5}, {40, 40}}));
+  REQUIRE(model.chunks().slotsIn({0, 0}) == std::vector<model::Slot>{first});
+  REQUIRE(model.chunks().slotsIn({2, 2}) == std::vector<model::Slot>{second});
+
+  model.remove(second);
+  REQUIRE(model.chunks().chunks() == std::vector<model::Chunk>{{0, 0}});
+
+  // every footprint stays within the bounds of its chunk, whichever way it is turned
+  for(const auto rotation : {model::QuarterTurn::Deg0, model::QuarterTurn::Deg90})
+  {
+    REQUIRE(model.moveTo(first, {15, 0}));
+    REQUIRE(model.rotateTo(first, rotation));
+    const auto bounds = model.chunkBounds({0, 0});
+    const auto footprint = model.footprint(first);
+    REQUIRE(footprint.min.x >= bounds.min.x);
+    REQUIRE(footprint.max.x <= bounds.max.x);
+    REQUIRE(footprint.min.z >= bounds.min.z);
+    REQUIRE(footprint.max.z <= bounds.max.z);
+  }
+}
+
+TEST_CASE("Quarter turns wrap around")
+{
+  auto rotation = model::QuarterTurn::Deg0;
+  rotation = model::rotatedByQuarter(rotation);
+  REQUIRE(rotation == model::QuarterTurn::Deg90);
+  rotation = model::rotatedByQuarter(model::rotatedByQuarter(model::rotatedByQuarter(rotation)));
+  REQUIRE(rotation == model::QuarterTurn::Deg0);
+}
@@ -1,8 +1,189 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "Cell.hpp"
+#include "ChunkIndex.hpp"
+#include "OccupancyIndex.hpp"
+
 namespace model
 {
+  constexpr auto noSlot = std::numeric_limits<Slot>::max();
+
+  enum class QuarterTurn : std::uint8_t
+  {
+    Deg0,
+    Deg90,
+    Deg180,
+    Deg270,
+  };
+
+  QuarterTurn rotatedByQuarter(QuarterTurn rotation);
+
+  enum class BrickType : std::uint8_t
+  {
+    Brick2x1,
+  };
+
+  constexpr auto brickTypeCount = static_cast<std::size_t>(BrickType::Brick2x1) + 1;
+
+  // size of an unrotated brick in cells; length runs along x, width along z
+  struct BrickShape
+  {
+    std::int32_t length{};
+    std::int32_t width{};
+  };
+
+  // Range the model is built for. Cells within +-cellLimit on both axes and bricks of 1 to maxBrickExtent cells per
+  // side keep footprints, chunk bounds and the pick walk clear of integer overflow.
+  constexpr auto cellLimit = std::int32_t{1} << 30;
+  constexpr auto maxBrickExtent = std::int32_t{1} << 10;
+
+  inline bool isValidCell(Cell cell)
+  {
+    return -cellLimit <= cell.x && cell.x <= cellLimit && -cellLimit <= cell.z && cell.z <= cellLimit;
+  }
+
+  inline bool isValidShape(BrickShape shape)
+  {
+    return 0 < shape.length && shape.length <= maxBrickExtent && 0 < shape.width && shape.width <= maxBrickExtent;
+  }
+
+  CellBox footprintOf(Cell cell, QuarterTurn rotation, BrickShape shape);
+
+  // result of a batched overlap query: slot overlaps the box at index query
+  struct Overlap
+  {
+    std::size_t query{};
+    Slot slot{};
+  };
+
+  // Points along origin + distance * direction. x and z are in cell units, so cell {x, z} spans [x, x + 1) on both
+  // axes; y is in the same units as the brick height passed to pick().
+  struct Ray
+  {
+    std::array<float, 3> origin{};
+    std::array<float, 3> direction{};
+  };
+
+  struct Hit
+  {
+    Slot slot{};
+    float distance{};
+  };
+
+  enum class ChangeKind : std::uint8_t
+  {
+    None,
+    Inserted,
+    Updated,
+    Removed,
+  };
+
+  struct Change
+  {
+    Slot slot{};
+    ChangeKind kind{};
+  };
+
+  inline bool operator==(const Change& lhs, const Change& rhs)
+  {
+    return lhs.slot == rhs.slot && lhs.kind == rhs.kind;
+  }
+
+  // Bricks are stored column-wise. A slot stays valid until the brick is removed, after which it may be reused.
+  // No two bricks ever cover the same cell: placements that would overlap are rejected and change nothing. Cells and
+  // shapes passed in must be valid, see isValidCell() and isValidShape().
   class Model
   {
+  public:
+    std::optional<Slot> add(Cell cell, QuarterTurn rotation, BrickType type = BrickType::Brick2x1);
+    void remove(Slot slot);
+
+    // room for that many bricks of the given type without reallocating, e.g. before loading a saved model
+    void reserve(std::size_t bricks, BrickType type = BrickType::Brick2x1);
+
+    bool contains(Slot slot) const;
+    std::size_t size() const;
+    std::size_t slotCount() const;
+
+    Cell cell(Slot slot) const;
+    QuarterTurn rotation(Slot slot) const;
+    BrickType type(Slot slot) const;
+
+    bool moveTo(Slot slot, Cell cell);
+    bool rotateTo(Slot slot, QuarterTurn rotation);
+
+    // all or nothing: either every brick is placed, or none moves (also when a slot is listed twice)
+    bool moveMany(const std::vector<Slot>& slots, const std::vector<Cell>& cells);
+    bool rotateMany(const std::vector<Slot>& slots);
+
+    // brick covering the cell, if any
+    std::optional<Slot> occupant(Cell cell) const;
+
+    // cells covered by the brick in its current rotation, derived from cell and shape rather than stored
+    CellBox footprint(Slot slot) const;
+
+    // bricks overlapping the box, sorted by slot
+    std::vector<Slot> overlapping(const CellBox& box) const;
+    // all overlaps for several boxes, grouped by query in the order of boxes
+    std::vector<Overlap> overlapping(const std::vector<CellBox>& boxes) const;
+
+    // Nearest brick along the ray, with bricks as boxes over their footprint from y = 0 to height. Walks the cells
+    // under the part of the ray inside that slab, so the cost depends on the ray, not on the number of bricks.
+    std::optional<Hit> pick(const Ray& ray, float height) const;
+
+    // Bricks grouped by the chunk of their cell. A brick may reach beyond its chunk, but not beyond chunkBounds().
+    const ChunkIndex& chunks() const;
+    CellBox chunkBounds(Chunk chunk) const;
+
+    // Change log since the last call, in the order the slots were first touched. Each slot is listed at most once
+    // with its combined change: a brick added and moved is Inserted, one added and removed again is not listed, and a
+    // slot removed and reused by a new brick is Updated.
+    std::vector<Change> takeChanges();
+    // whether anything was recorded since the last takeChanges(), even if it cancelled out since
+    bool hasChanges() const;
+
+    // only while the model is empty, as existing placements may not fit the new shape
+    void setShape(BrickType type, BrickShape shape);
+    BrickShape shape(BrickType type) const;
+
+    // Indexed by slot. Entries of removed slots hold stale values, check contains() when iterating.
+    const std::vector<Cell>& cells() const;
+
+  private:
+    // rotation, type, liveness and pending change of a brick packed into one byte
+    struct State
+    {
+      std::uint8_t quarterTurns : 2;
+      std::uint8_t type : 3;
+      std::uint8_t alive : 1;
+      std::uint8_t change : 2;
+    };
+    static_assert(sizeof(State) == 1);
+    static_assert(brickTypeCount <= 1u << 3, "State::type holds 3 bits");
+
+    bool place(Slot slot, Cell cell, QuarterTurn rotation);
+    void record(Slot slot, ChangeKind kind);
+    void appendOverlapping(const CellBox& box, std::vector<Slot>& slots) const;
+
+    template<typename NewPlacement>
+    bool relocate(const std::vector<Slot>& slots, NewPlacement newPlacement);
+
+    std::vector<Cell> cells_;
+    std::vector<State> states_;
+
+    std::vector<Slot> freeSlots_;
+    // slots with a pending change, in order; may hold a slot twice if its changes cancelled out in between
+    std::vector<Slot> changed_;
+
+    BrickShape brick2x1Shape_{4, 2};
+    OccupancyIndex occupancy_;
+    ChunkIndex chunks_;
   };
 } // namespace model
@@ -0,0 +1,138 @@
+#include "OccupancyIndex.hpp"
+
+#include <algorithm>
+
+namespace model
+{
+  std::optional<Slot> OccupancyIndex::at(Cell cell) const
+  {
+    const auto found = slots_.find(keyOf(cell));
+    if(found == slots_.end()) return std::nullopt;
+    return found->second;
+  }
+
+  bool OccupancyIndex::isFree(const CellBox& box, Slot owner) const
+  {
+    for(auto x = box.min.x; x < box.max.x; ++x)
+    {
+      for(auto z = box.min.z; z < box.max.z; ++z)
+      {
+        const auto found = slots_.find(keyOf({x, z}));
+        if(found != slots_.end() && found->second != owner) return false;
+      }
+    }
+    return true;
+  }
+
+  void OccupancyIndex::occupy(const CellBox& box, Slot slot)
+  {
+    if(cellCount(box) == 0) return;
+
+    forEachCell(box, [this, slot](Cell cell) { slots_[keyOf(cell)] = slot; });
+
+    if(boundsStale_) return;
+    if(cellCount(bounds_) == 0)
+    {
+      bounds_ = box;
+      return;
+    }
+    bounds_.min = {std::min(bounds_.min.x, box.min.x), std::min(bounds_.min.z, box.min.z)};
+    bounds_.max = {std::max(bounds_.max.x, box.max.x), std::max(bounds_.max.z, box.max.z)};
+  }
+
+  void OccupancyIndex::release(const CellBox& box, Slot slot)
+  {
+    forEachCell(box, [this, slot](Cell cell) {
+      const auto found = slots_.find(keyOf(cell));
+      if(found == slots_.end() || found->second != slot) return;
+
+      slots_.erase(found);
+      const auto onEdge = cell.x == bounds_.min.x || cell.x + 1 == bounds_.max.x || cell.z == bounds_.min.z ||
+                          cell.z + 1 == bounds_.max.z;
+      if(onEdge) boundsStale_ = true;
+    });
+  }
+
+  std::size_t OccupancyIndex::occupiedCells() const
+  {
+    return slots_.size();
+  }
+
+  void OccupancyIndex::reserve(std::size_t cells)
+  {
+    slots_.reserve(cells);
+  }
+
+  const CellBox& OccupancyIndex::bounds() const
+  {
+    if(!boundsStale_) return bounds_;
+
+    boundsStale_ = false;
+    bounds_ = {};
+    for(auto found = slots_.begin(); found != slots_.end(); ++found)
+    {
+      const auto cell = cellOf(found->first);
+      if(found == slots_.begin())
+      {
+        bounds_ = {cell, {cell.x + 1, cell.z + 1}};
+        continue;
+      }
+      bounds_.min = {std::min(bounds_.min.x, cell.x), std::min(bounds_.min.z, cell.z)};
+      bounds_.max = {std::max(bounds_.max.x, cell.x + 1), std::max(bounds_.max.z, cell.z + 1)};
+    }
+    return bounds_;
+  }
+
+  std::uint64_t OccupancyIndex::keyOf(Cell cell)
+  {
+    return (std::uint64_t{static_cast<std::uint32_t>(cell.x)} << 32) | static_cast<std::uint32_t>(cell.z);
+  }
+
+  Cell OccupancyIndex::cellOf(std::uint64_t key)
+  {
+    const auto x = static_cast<std::uint32_t>(key >> 32);
+    const auto z = static_cast<std::uint32_t>(key & 0xFFFFFFFF);
+    return {static_cast<std::int32_t>(x), static_cast<std::int32_t>(z)};
+  }
+} // namespace model
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("OccupancyIndex")
+{
+  auto index = model::OccupancyIndex();
+  const auto box = model::CellBox{{-1, 0}, {1, 2}};
+
+  REQUIRE(index.isFree(box, 7));
+  REQUIRE(model::cellCount(index.bounds()) == 0);
+  index.occupy(box, 7);
+  REQUIRE(index.occupiedCells() == 4);
+  REQUIRE(index.at({-1, 1}) == 7u);
+  REQUIRE(!index.at({1, 1}));
+
+  REQUIRE(index.isFree(box, 7));
+  REQUIRE(!index.isFree(box, 8));
+  REQUIRE(!index.isFree({{0, 1}, {3, 3}}, 8));
+  REQUIRE(index.isFree({{1, 0}, {3, 2}}, 8));
+
+  index.occupy({{4, -3}, {5, -2}}, 8);
+  REQUIRE(index.bounds() == model::CellBox{{-1, -3}, {5, 2}});
+
+  // releasing a box that reaches into another brick leaves that brick's cells alone
+  index.release({{-1, -3}, {5, 2}}, 7);
+  REQUIRE(index.occupiedCells() == 1);
+  REQUIRE(index.isFree(box, 8));
+  REQUIRE(index.at({4, -3}) == 8u);
+  REQUIRE(index.bounds() == model::CellBox{{4, -3}, {5, -2}});
+
+  // a stray brick far away no longer widens the bounds once it is gone
+  index.occupy(box, 7);
+  index.occupy({{1000000, 0}, {1000001, 1}}, 9);
+  REQUIRE(index.bounds().max.x == 1000001);
+  index.release({{1000000, 0}, {1000001, 1}}, 9);
+  REQUIRE(index.bounds() == model::CellBox{{-1, -3}, {5, 2}});
+
+  index.release(box, 7);
+  index.release({{4, -3}, {5, -2}}, 8);
+  REQUIRE(model::cellCount(index.bounds()) == 0);
+}
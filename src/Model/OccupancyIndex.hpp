@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+#include "Cell.hpp"
+
+namespace model
+{
+  // Sparse map from grid cell to the brick covering it.
+  class OccupancyIndex
+  {
+  public:
+    std::optional<Slot> at(Cell cell) const;
+
+    // true if every cell of the box is empty or already covered by owner
+    bool isFree(const CellBox& box, Slot owner) const;
+
+    void occupy(const CellBox& box, Slot slot);
+    // cells of the box that slot covers become empty; cells another brick took over keep their owner
+    void release(const CellBox& box, Slot slot);
+
+    std::size_t occupiedCells() const;
+    // room for that many occupied cells without rehashing
+    void reserve(std::size_t cells);
+
+    // Smallest box enclosing every occupied cell. Releasing cells on its edge leaves it to be recomputed on the next
+    // call, which takes one pass over the occupied cells.
+    const CellBox& bounds() const;
+
+  private:
+    static std::uint64_t keyOf(Cell cell);
+    static Cell cellOf(std::uint64_t key);
+
+    std::unordered_map<std::uint64_t, Slot> slots_;
+    mutable CellBox bounds_;
+    mutable bool boundsStale_{};
+  };
+} // namespace model
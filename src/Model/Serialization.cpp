@@ -0,0 +1,218 @@
+#include "Serialization.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace
+{
+  constexpr auto magic = std::array<std::uint8_t, 4>{'B', 'R', 'I', 'K'};
+  constexpr auto version = std::uint32_t{1};
+
+  constexpr auto brickTypes = std::array<model::BrickType, model::brickTypeCount>{model::BrickType::Brick2x1};
+
+  constexpr auto headerBytes = magic.size() + 4 + 1 + brickTypes.size() * 8 + 8;
+  constexpr auto brickBytes = std::size_t{4 + 4 + 1};
+
+  class Writer
+  {
+  public:
+    explicit Writer(std::vector<std::uint8_t>& bytes) : bytes_(bytes) {}
+
+    void write(std::uint64_t value, std::size_t size)
+    {
+      for(auto i = std::size_t{0}; i < size; ++i) bytes_.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+
+    void write(std::int32_t value)
+    {
+      write(static_cast<std::uint32_t>(value), 4);
+    }
+
+  private:
+    std::vector<std::uint8_t>& bytes_;
+  };
+
+  // Reads past the end yield zero and mark the reader as failed, so callers check once at the end.
+  class Reader
+  {
+  public:
+    explicit Reader(const std::vector<std::uint8_t>& bytes) : bytes_(bytes) {}
+
+    std::uint64_t read(std::size_t size)
+    {
+      if(bytes_.size() - position_ < size)
+      {
+        failed_ = true;
+        position_ = bytes_.size();
+        return 0;
+      }
+
+      auto value = std::uint64_t{0};
+      for(auto i = std::size_t{0}; i < size; ++i) value |= std::uint64_t{bytes_[position_ + i]} << (8 * i);
+      position_ += size;
+      return value;
+    }
+
+    std::int32_t readInt32()
+    {
+      return static_cast<std::int32_t>(static_cast<std::uint32_t>(read(4)));
+    }
+
+    std::size_t remaining() const
+    {
+      return bytes_.size() - position_;
+    }
+
+    bool failed() const
+    {
+      return failed_;
+    }
+
+  private:
+    const std::vector<std::uint8_t>& bytes_;
+    std::size_t position_{};
+    bool failed_{};
+  };
+} // namespace
+
+namespace model
+{
+  std::vector<std::uint8_t> serialize(const Model& model)
+  {
+    auto bytes = std::vector<std::uint8_t>();
+    bytes.reserve(headerBytes + model.size() * brickBytes);
+
+    auto writer = Writer(bytes);
+    for(const auto byte : magic) writer.write(byte, 1);
+    writer.write(version, 4);
+
+    writer.write(brickTypeCount, 1);
+    for(const auto type : brickTypes)
+    {
+      writer.write(model.shape(type).length);
+      writer.write(model.shape(type).width);
+    }
+
+    writer.write(model.size(), 8);
+    for(auto slot = Slot{0}; slot < model.slotCount(); ++slot)
+    {
+      if(!model.contains(slot)) continue;
+
+      writer.write(model.cell(slot).x);
+      writer.write(model.cell(slot).z);
+      // rotation in the low two bits, type above
+      writer.write(static_cast<std::uint8_t>(static_cast<std::uint8_t>(model.rotation(slot)) |
+                                             static_cast<std::uint8_t>(model.type(slot)) << 2),
+                   1);
+    }
+    return bytes;
+  }
+
+  std::optional<Model> deserialize(const std::vector<std::uint8_t>& bytes)
+  {
+    auto reader = Reader(bytes);
+    for(const auto byte : magic)
+    {
+      if(reader.read(1) != byte) return std::nullopt;
+    }
+    if(reader.read(4) != version || reader.read(1) != brickTypeCount) return std::nullopt;
+
+    auto model = Model();
+    for(const auto type : brickTypes)
+    {
+      const auto length = reader.readInt32();
+      const auto width = reader.readInt32();
+      const auto shape = BrickShape{length, width};
+      if(!isValidShape(shape)) return std::nullopt;
+      model.setShape(type, shape);
+    }
+
+    const auto count = reader.read(8);
+    // a corrupt count may be large enough for the multiplication to wrap
+    if(reader.failed() || count > reader.remaining() / brickBytes || reader.remaining() != count * brickBytes)
+      return std::nullopt;
+
+    model.reserve(static_cast<std::size_t>(count));
+    for(auto i = std::uint64_t{0}; i < count; ++i)
+    {
+      const auto x = reader.readInt32();
+      const auto z = reader.readInt32();
+      const auto packed = static_cast<std::uint8_t>(reader.read(1));
+      const auto typeIndex = static_cast<std::size_t>(packed >> 2);
+      if(typeIndex >= brickTypes.size()) return std::nullopt;
+
+      const auto cell = Cell{x, z};
+      if(!isValidCell(cell)) return std::nullopt;
+
+      const auto rotation = static_cast<QuarterTurn>(packed & 3);
+      if(!model.add(cell, rotation, brickTypes[typeIndex])) return std::nullopt;
+    }
+
+    // a loaded model starts out unchanged
+    model.takeChanges();
+    return model;
+  }
+} // namespace model
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Models survive a round trip through their serialized form")
+{
+  auto original = model::Model();
+  const auto first = *original.add({0, 0}, model::QuarterTurn::Deg0);
+  original.add({10, -20}, model::QuarterTurn::Deg90);
+  original.add({-100000, 7}, model::QuarterTurn::Deg270);
+  original.remove(first);
+
+  const auto bytes = model::serialize(original);
+  REQUIRE(bytes.size() == headerBytes + 2 * brickBytes);
+
+  const auto loaded = model::deserialize(bytes);
+  REQUIRE(loaded);
+  REQUIRE(loaded->size() == 2);
+  REQUIRE(loaded->slotCount() == 2);
+  REQUIRE(loaded->cell(0) == model::Cell{10, -20});
+  REQUIRE(loaded->rotation(0) == model::QuarterTurn::Deg90);
+  REQUIRE(loaded->cell(1) == model::Cell{-100000, 7});
+  REQUIRE(loaded->rotation(1) == model::QuarterTurn::Deg270);
+  REQUIRE(loaded->occupant({10, -20}) == model::Slot{0});
+  REQUIRE(model::serialize(*loaded) == bytes);
+
+  auto changes = *loaded;
+  REQUIRE(changes.takeChanges().empty());
+}
+
+TEST_CASE("Broken serialized models are rejected")
+{
+  auto original = model::Model();
+  original.add({0, 0}, model::QuarterTurn::Deg0);
+  const auto bytes = model::serialize(original);
+
+  REQUIRE(!model::deserialize({}));
+  REQUIRE(!model::deserialize(std::vector<std::uint8_t>(bytes.begin(), bytes.end() - 1)));
+
+  auto wrongMagic = bytes;
+  wrongMagic[0] = 'X';
+  REQUIRE(!model::deserialize(wrongMagic));
+
+  // a count whose byte size does not fit into 64 bits
+  auto hugeCount = bytes;
+  std::fill(hugeCount.begin() + headerBytes - 8, hugeCount.begin() + headerBytes, std::uint8_t{0xFF});
+  REQUIRE(!model::deserialize(hugeCount));
+
+  // shapes and cells out of the model's range
+  auto hugeShape = bytes;
+  hugeShape[magic.size() + 4 + 1 + 3] = 0x7F;
+  REQUIRE(!model::deserialize(hugeShape));
+
+  auto farCell = bytes;
+  farCell[headerBytes + 3] = 0x7F;
+  REQUIRE(!model::deserialize(farCell));
+
+  // the same brick twice overlaps itself
+  auto overlapping = bytes;
+  overlapping[headerBytes - 8] = 2;
+  overlapping.insert(overlapping.end(), bytes.end() - brickBytes, bytes.end());
+  REQUIRE(!model::deserialize(overlapping));
+}
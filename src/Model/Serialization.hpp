@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Model.hpp"
+
+namespace model
+{
+  // Compact binary form of a model: the brick shapes, then cell, rotation and type of every brick in slot order.
+  // Integers are little-endian, so files move between machines. Slots are not kept; loading numbers the bricks from 0
+  // in the order they were saved, and drops pending changes.
+  std::vector<std::uint8_t> serialize(const Model& model);
+
+  // empty for data that is truncated, from another format version, out of the model's range, or places bricks onto
+  // each other
+  std::optional<Model> deserialize(const std::vector<std::uint8_t>& bytes);
+} // namespace model
@@ -0,0 +1,296 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include "BenchSupport/BenchReport.hpp"
+#include "BenchSupport/Options.hpp"
+#include "BenchSupport/ProcessStats.hpp"
+#include "Model/Model.hpp"
+#include "Model/Serialization.hpp"
+#include "Program/Glue/GridPolicy.hpp"
+#include "Program/Glue/ModelAdapter.hpp"
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double nanosecondsBetween(Clock::time_point start, Clock::time_point end)
+  {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+  }
+
+  // Runs operation(i) for i in [0, operations) and times each call. An operation handles itemsPerOperation items, e.g.
+  // the bricks of a batched move, and returns whether it succeeded.
+  template<typename Operation>
+  QJsonObject measure(const QString& name,
+                      std::size_t bricks,
+                      std::size_t operations,
+                      std::size_t itemsPerOperation,
+                      Operation operation)
+  {
+    auto latencies = std::vector<double>();
+    latencies.reserve(operations);
+    auto succeeded = std::size_t{0};
+
+    const auto start = Clock::now();
+    for(auto i = std::size_t{0}; i < operations; ++i)
+    {
+      const auto before = Clock::now();
+      succeeded += operation(i) ? 1 : 0;
+      latencies.push_back(nanosecondsBetween(before, Clock::now()));
+    }
+    const auto seconds = nanosecondsBetween(start, Clock::now()) / 1e9;
+
+    std::cerr << "  " << name.toStdString() << ": " << static_cast<double>(operations) / seconds << " per second\n";
+    return QJsonObject{
+      {QStringLiteral("operation"), name},
+      {QStringLiteral("bricks"), static_cast<double>(bricks)},
+      {QStringLiteral("operations"), static_cast<double>(operations)},
+      {QStringLiteral("itemsPerOperation"), static_cast<double>(itemsPerOperation)},
+      {QStringLiteral("succeeded"), static_cast<double>(succeeded)},
+      {QStringLiteral("seconds"), seconds},
+      {QStringLiteral("operationsPerSecond"), static_cast<double>(operations) / seconds},
+      {QStringLiteral("itemsPerSecond"), static_cast<double>(operations * itemsPerOperation) / seconds},
+      {QStringLiteral("latencyNs"), bench::toJson(bench::summarize(std::move(latencies)))},
+    };
+  }
+
+  // Bricks are 4 x 2 cells. Eight cells apart, every brick can turn and move two cells in any direction.
+  constexpr auto pitch = 8;
+  constexpr auto step = 2;
+
+  model::Model makeField(std::size_t count)
+  {
+    const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+
+    auto model = model::Model();
+    model.reserve(count);
+    for(auto i = std::size_t{0}; i < count; ++i)
+    {
+      const auto x = static_cast<std::int32_t>(i % side) * pitch;
+      const auto z = static_cast<std::int32_t>(i / side) * pitch;
+      model.add({x, z}, i % 2 == 0 ? model::QuarterTurn::Deg0 : model::QuarterTurn::Deg90);
+    }
+    model.takeChanges();
+    return model;
+  }
+
+  // bricks picked at random, the same for every run
+  std::vector<model::Slot> randomSlots(std::mt19937_64& random, std::size_t bricks, std::size_t count)
+  {
+    auto slots = std::vector<model::Slot>(count);
+    auto distribution = std::uniform_int_distribution<model::Slot>(0, static_cast<model::Slot>(bricks - 1));
+    for(auto& slot : slots) slot = distribution(random);
+    return slots;
+  }
+
+  // Moves go back and forth by one step, so the field keeps its layout however many run.
+  model::Cell steppedCell(model::Cell cell, std::size_t i)
+  {
+    return i % 2 == 0 ? model::Cell{cell.x + step, cell.z} : model::Cell{cell.x - step, cell.z};
+  }
+
+  void benchmarkModel(QJsonArray& results, std::size_t bricks, std::size_t operations, std::mt19937_64& random)
+  {
+    auto model = makeField(bricks);
+    const auto slots = randomSlots(random, bricks, operations);
+
+    results.append(measure(QStringLiteral("model.moveTo"), bricks, operations, 1, [&](std::size_t i) {
+      const auto slot = slots[i / 2 * 2];
+      return model.moveTo(slot, steppedCell(model.cell(slot), i));
+    }));
+
+    results.append(measure(QStringLiteral("model.rotateTo"), bricks, operations, 1, [&](std::size_t i) {
+      return model.rotateTo(slots[i], model::rotatedByQuarter(model.rotation(slots[i])));
+    }));
+
+    constexpr auto batchSize = std::size_t{64};
+    const auto batches = std::max(std::size_t{1}, operations / batchSize);
+    auto batchSlots = std::vector<std::vector<model::Slot>>();
+    for(auto batch = std::size_t{0}; batch < batches; ++batch)
+    {
+      // distinct slots, as the model rejects batches listing a brick twice
+      const auto first = static_cast<model::Slot>(batch * batchSize % bricks);
+      auto slotsOfBatch = std::vector<model::Slot>();
+      for(auto j = std::size_t{0}; j < std::min(batchSize, bricks); ++j)
+      {
+        slotsOfBatch.push_back(static_cast<model::Slot>((first + j) % bricks));
+      }
+      batchSlots.push_back(std::move(slotsOfBatch));
+    }
+    auto cells = std::vector<model::Cell>();
+    results.append(
+      measure(QStringLiteral("model.moveMany"), bricks, batches, std::min(batchSize, bricks), [&](std::size_t i) {
+        const auto& slotsOfBatch = batchSlots[i / 2];
+        cells.clear();
+        for(const auto slot : slotsOfBatch) cells.push_back(steppedCell(model.cell(slot), i));
+        return model.moveMany(slotsOfBatch, cells);
+      }));
+    model.takeChanges();
+
+    const auto side = static_cast<std::int32_t>(std::ceil(std::sqrt(static_cast<double>(bricks)))) * pitch;
+    auto cellDistribution = std::uniform_int_distribution<std::int32_t>(0, side);
+    auto queryCells = std::vector<model::Cell>(operations);
+    for(auto& cell : queryCells) cell = {cellDistribution(random), cellDistribution(random)};
+
+    results.append(measure(QStringLiteral("model.occupant"), bricks, operations, 1, [&](std::size_t i) {
+      return model.occupant(queryCells[i]).has_value();
+    }));
+
+    results.append(measure(QStringLiteral("model.overlapping 16x16"), bricks, operations, 1, [&](std::size_t i) {
+      const auto min = queryCells[i];
+      return !model.overlapping(model::CellBox{min, {min.x + 16, min.z + 16}}).empty();
+    }));
+
+    // Camera rays as the UI casts them: from a ring around and above the field down to a random point on it, so
+    // grazing rays walk far across the field and steep ones hit almost at once.
+    constexpr auto brickHeight = 1.0f;
+    const auto centre = 0.5f * static_cast<float>(side);
+    auto unit = std::uniform_real_distribution<float>(0.0f, 1.0f);
+    auto rays = std::vector<model::Ray>(operations);
+    for(auto& ray : rays)
+    {
+      const auto azimuth = 6.2831853f * unit(random);
+      const auto distance = centre * (1.0f + unit(random));
+      const auto height = 0.2f * distance + 40.0f * unit(random);
+      const auto origin =
+        std::array<float, 3>{centre + distance * std::cos(azimuth), height, centre + distance * std::sin(azimuth)};
+      const auto targetX = static_cast<float>(side) * unit(random);
+      const auto targetZ = static_cast<float>(side) * unit(random);
+      ray = {origin, {targetX - origin[0], -height, targetZ - origin[2]}};
+    }
+
+    results.append(measure(QStringLiteral("model.pick"), bricks, operations, 1, [&](std::size_t i) {
+      return model.pick(rays[i], brickHeight).has_value();
+    }));
+
+    constexpr auto serializationRuns = std::size_t{3};
+    auto bytes = std::vector<std::uint8_t>();
+    results.append(measure(QStringLiteral("serialize"), bricks, serializationRuns, bricks, [&](std::size_t) {
+      bytes = model::serialize(model);
+      return !bytes.empty();
+    }));
+    results.append(measure(QStringLiteral("deserialize"), bricks, serializationRuns, bricks, [&](std::size_t) {
+      return model::deserialize(bytes).has_value();
+    }));
+
+    // Through the adapter, as the UI calls it: snapping, constraining and converting to cells on top of the model.
+    const auto cellsToWorld = 0.5f;
+    const auto bound = cellsToWorld * static_cast<float>(side + pitch);
+    auto adapter = ModelAdapter(std::move(model), RuntimeGridPolicy(cellsToWorld, bound, Axis::x | Axis::z));
+
+    results.append(measure(QStringLiteral("adapter.moveTo"), bricks, operations, 1, [&](std::size_t i) {
+      const auto handle = slots[i / 2 * 2];
+      const auto offset = cellsToWorld * static_cast<float>(i % 2 == 0 ? step : -step);
+      adapter.moveTo(handle, adapter.position(handle) + QVector3D(offset, 0.0f, 0.0f));
+      return true;
+    }));
+
+    results.append(measure(QStringLiteral("adapter.rotate"), bricks, operations, 1, [&](std::size_t i) {
+      adapter.rotate(slots[i]);
+      return true;
+    }));
+  }
+
+  // Snapping does not depend on the number of bricks. Values are timed in blocks, as a single one takes about as
+  // long as reading the clock.
+  void benchmarkGrid(QJsonArray& results, std::size_t operations, std::mt19937_64& random)
+  {
+    constexpr auto blockSize = std::size_t{1024};
+    const auto blocks = std::max(std::size_t{1}, operations / blockSize);
+
+    auto distribution = std::uniform_real_distribution<float>(-10.0f, 10.0f);
+    auto values = std::vector<float>(blocks * blockSize);
+    for(auto& value : values) value = distribution(random);
+
+    auto sink = 0.0f;
+    const auto scalar = [&](const auto& grid) {
+      return [&grid, &values, &sink](std::size_t block) {
+        for(auto i = block * blockSize; i < (block + 1) * blockSize; ++i)
+        {
+          sink += grid.constrain(grid.snapToGrid({values[i], 0.0f, values[i]})).x();
+        }
+        return true;
+      };
+    };
+
+    const auto defaultGrid = DefaultGrid();
+    const auto runtimeGrid = RuntimeGridPolicy(0.3f, 3.0f, Axis::x | Axis::z);
+    results.append(
+      measure(QStringLiteral("DefaultGrid snapToGrid+constrain"), 0, blocks, blockSize, scalar(defaultGrid)));
+    results.append(
+      measure(QStringLiteral("RuntimeGrid snapToGrid+constrain"), 0, blocks, blockSize, scalar(runtimeGrid)));
+
+    auto batch = values;
+    const auto batched = [&](std::size_t block) {
+      defaultGrid.snapAndConstrain(batch.data() + block * blockSize, blockSize);
+      return true;
+    };
+    results.append(measure(QStringLiteral("DefaultGrid snapAndConstrain"), 0, blocks, blockSize, batched));
+
+    // keeps the compiler from dropping the scalar loops
+    if(std::isnan(sink)) std::cerr << "unexpected NaN\n";
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QStringLiteral("Measures the model operations behind dragging and loading."));
+  parser.addHelpOption();
+  const auto sizesOption = QCommandLineOption(QStringLiteral("sizes"),
+                                              QStringLiteral("Comma separated brick counts."),
+                                              QStringLiteral("counts"),
+                                              QStringLiteral("1000,10000,100000,1000000,10000000"));
+  const auto operationsOption = QCommandLineOption(QStringLiteral("operations"),
+                                                   QStringLiteral("Operations timed per benchmark."),
+                                                   QStringLiteral("count"),
+                                                   QStringLiteral("100000"));
+  const auto seedOption = QCommandLineOption(
+    QStringLiteral("seed"), QStringLiteral("Seed of the random choices."), QStringLiteral("seed"), QStringLiteral("1"));
+  const auto outputOption = QCommandLineOption(QStringLiteral("output"),
+                                               QStringLiteral("JSON file to write."),
+                                               QStringLiteral("path"),
+                                               QStringLiteral("model-bench.json"));
+  parser.addOptions({sizesOption, operationsOption, seedOption, outputOption});
+  parser.process(app);
+
+  const auto operations = static_cast<std::size_t>(parser.value(operationsOption).toULongLong());
+  auto random = std::mt19937_64(parser.value(seedOption).toULongLong());
+
+  auto report = bench::reportHeader(QStringLiteral("model"));
+  report[QStringLiteral("seed")] = parser.value(seedOption);
+
+  // the clock is read around every operation, so this much of each latency is the clock itself
+  auto overhead = std::vector<double>();
+  for(auto i = 0; i < 10000; ++i)
+  {
+    const auto before = Clock::now();
+    overhead.push_back(nanosecondsBetween(before, Clock::now()));
+  }
+  report[QStringLiteral("clockOverheadNs")] = bench::summarize(std::move(overhead)).p50;
+
+  auto results = QJsonArray();
+  std::cerr << "grid\n";
+  benchmarkGrid(results, operations, random);
+  for(const auto bricks : bench::parseCounts(parser.value(sizesOption)))
+  {
+    std::cerr << bricks << " bricks\n";
+    benchmarkModel(results, bricks, operations, random);
+  }
+  report[QStringLiteral("results")] = results;
+  report[QStringLiteral("peakRssBytes")] = static_cast<double>(bench::peakResidentBytes());
+
+  return bench::writeReport(parser.value(outputOption), report) ? 0 : 1;
+}
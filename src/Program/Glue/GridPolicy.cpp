@@ -0,0 +1,217 @@
+#include "GridPolicy.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+  bool isPowerOfTwo(float value)
+  {
+    auto bits = std::uint32_t{};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    constexpr auto mantissaBits = std::uint32_t{0x007FFFFF};
+    return std::isnormal(value) && value > 0.0f && (bits & mantissaBits) == 0;
+  }
+} // namespace
+
+RuntimeGridPolicy::RuntimeGridPolicy(float spacing, float bound, unsigned snappedAxes) :
+  spacing_(spacing),
+  inverseSpacing_(1.0f / spacing),
+  bound_(bound),
+  snappedAxes_(snappedAxes),
+  powerOfTwoSpacing_(isPowerOfTwo(spacing))
+{
+  assert(spacing > 0.0f);
+  assert(bound >= 0.0f);
+}
+
+float RuntimeGridPolicy::snap(float value) const
+{
+  if(powerOfTwoSpacing_) return std::round(value * inverseSpacing_) * spacing_;
+  return std::round(value / spacing_) * spacing_;
+}
+
+float RuntimeGridPolicy::constrain(float value) const
+{
+  return std::clamp(value, -bound_, bound_);
+}
+
+std::int32_t RuntimeGridPolicy::toCell(float value) const
+{
+  if(powerOfTwoSpacing_) return detail::toCellIndex(std::round(value * inverseSpacing_));
+  return detail::toCellIndex(std::round(value / spacing_));
+}
+
+float RuntimeGridPolicy::toWorld(std::int32_t cell) const
+{
+  return static_cast<float>(cell) * spacing_;
+}
+
+QVector3D RuntimeGridPolicy::snapToGrid(QVector3D position) const
+{
+  return detail::snapToGrid(*this, position);
+}
+
+QVector3D RuntimeGridPolicy::constrain(QVector3D position) const
+{
+  return detail::constrain(*this, position);
+}
+
+void RuntimeGridPolicy::snapAndConstrain(float* values, std::size_t count) const
+{
+  if(powerOfTwoSpacing_)
+    snapAndConstrainPowerOfTwo(values, count, spacing_, bound_);
+  else
+    ::snapAndConstrain(values, count, spacing_, bound_);
+}
+
+#include <limits>
+#include <vector>
+
+#include <doctest/doctest.hpp>
+
+namespace
+{
+  std::uint32_t bitsOf(float value)
+  {
+    auto bits = std::uint32_t{};
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  std::vector<float> snapTestValues()
+  {
+    auto values = std::vector<float>{0.0f,
+                                     -0.0f,
+                                     0.25f,
+                                     -0.25f,
+                                     0.75f,
+                                     -0.75f,
+                                     -0.1f,
+                                     2.9999f,
+                                     -3.25f,
+                                     1e10f,
+                                     -1e10f,
+                                     8388607.5f,
+                                     std::numeric_limits<float>::denorm_min(),
+                                     std::numeric_limits<float>::infinity(),
+                                     -std::numeric_limits<float>::infinity(),
+                                     std::numeric_limits<float>::quiet_NaN()};
+
+    auto state = std::uint32_t{12345};
+    for(auto i = 0; i < 1000; ++i)
+    {
+      state = state * 1664525u + 1013904223u;
+      values.push_back(static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 20.0f - 10.0f);
+    }
+
+    return values;
+  }
+
+  template<typename Policy>
+  void requireBatchMatchesScalar(const Policy& grid)
+  {
+    const auto values = snapTestValues();
+
+    // every length up to a few vector widths, so both the vector body and the scalar tail run
+    for(auto count = std::size_t{0}; count <= 19; ++count)
+    {
+      auto batch = std::vector<float>(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(count));
+      grid.snapAndConstrain(batch.data(), batch.size());
+
+      for(auto i = std::size_t{0}; i < count; ++i)
+      {
+        REQUIRE(bitsOf(batch[i]) == bitsOf(grid.constrain(grid.snapToGrid({values[i], 0.0f, 0.0f})).x()));
+      }
+    }
+
+    auto batch = values;
+    grid.snapAndConstrain(batch.data(), batch.size());
+    for(auto i = std::size_t{0}; i < values.size(); ++i)
+    {
+      REQUIRE(bitsOf(batch[i]) == bitsOf(grid.constrain(grid.snapToGrid({values[i], 0.0f, 0.0f})).x()));
+    }
+  }
+} // namespace
+
+TEST_CASE("snapToGrid")
+{
+  const auto grid = DefaultGrid();
+  REQUIRE(grid.snapToGrid({0.0f, 0.0f, 0.0f}) == QVector3D{0.0f, 0.0f, 0.0f});
+  REQUIRE(grid.snapToGrid({0.3f, 0.0f, 0.0f}) == QVector3D{0.5f, 0.0f, 0.0f});
+  REQUIRE(grid.snapToGrid({0.6f, 0.0f, 0.0f}) == QVector3D{0.5f, 0.0f, 0.0f});
+  REQUIRE(grid.snapToGrid({0.25f, 0.0f, 0.0f}) == QVector3D{0.5f, 0.0f, 0.0f});
+  REQUIRE(grid.snapToGrid({0.0f, 0.0f, 0.3f}) == QVector3D{0.0f, 0.0f, 0.5f});
+  REQUIRE(grid.snapToGrid({0.0f, 0.0f, 0.6f}) == QVector3D{0.0f, 0.0f, 0.5f});
+  REQUIRE(grid.snapToGrid({0.0f, 0.3f, 0.0f}) == QVector3D{0.0f, 0.3f, 0.0f});
+}
+
+TEST_CASE("constrain")
+{
+  const auto grid = DefaultGrid();
+  REQUIRE(grid.constrain({0.0f, 0.0f, 0.0f}) == QVector3D{0.0f, 0.0f, 0.0f});
+  REQUIRE(grid.constrain({5.0f, 0.0f, 0.0f}) == QVector3D{3.0f, 0.0f, 0.0f});
+  REQUIRE(grid.constrain({0.0f, 0.0f, 5.0f}) == QVector3D{0.0f, 0.0f, 3.0f});
+  REQUIRE(grid.constrain({-5.0f, 0.0f, 0.0f}) == QVector3D{-3.0f, 0.0f, 0.0f});
+  REQUIRE(grid.constrain({0.0f, 0.0f, -5.0f}) == QVector3D{0.0f, 0.0f, -3.0f});
+  REQUIRE(grid.constrain({5.0f, 0.0f, -5.0f}) == QVector3D{3.0f, 0.0f, -3.0f});
+}
+
+TEST_CASE("GridPolicy with other spacings")
+{
+  using ThirdGrid = GridPolicy<std::ratio<1, 3>, std::ratio<10>, Axis::x | Axis::y | Axis::z>;
+  REQUIRE(ThirdGrid::snap(0.4f) == std::round(0.4f / (1.0f / 3.0f)) * (1.0f / 3.0f));
+  REQUIRE(ThirdGrid::snapToGrid({0.1f, 0.2f, 10.4f}).y() == ThirdGrid::snap(0.2f));
+
+  using CoarseGrid = GridPolicy<std::ratio<4>, std::ratio<100>, Axis::z>;
+  REQUIRE(CoarseGrid::snapToGrid({3.0f, 3.0f, 3.0f}) == QVector3D{3.0f, 3.0f, 4.0f});
+  REQUIRE(CoarseGrid::constrain({300.0f, 300.0f, 300.0f}) == QVector3D{300.0f, 300.0f, 100.0f});
+
+  const auto runtimeGrid = RuntimeGridPolicy(0.5f, 3.0f, Axis::x | Axis::z);
+  for(const auto value : snapTestValues())
+  {
+    REQUIRE(bitsOf(runtimeGrid.snap(value)) == bitsOf(DefaultGrid::snap(value)));
+  }
+}
+
+TEST_CASE("Grid cells round-trip snapped positions")
+{
+  REQUIRE(DefaultGrid::toCell(1.5f) == 3);
+  REQUIRE(DefaultGrid::toCell(-0.3f) == -1);
+  REQUIRE(DefaultGrid::toWorld(-6) == -3.0f);
+
+  const auto thirds = RuntimeGridPolicy(0.3f, 3.0f, Axis::x | Axis::z);
+  for(const auto value : {0.0f, 0.31f, -1.2f, 2.95f, -3.5f})
+  {
+    const auto placed = thirds.constrain(thirds.snap(value));
+    REQUIRE(bitsOf(thirds.toWorld(thirds.toCell(placed))) == bitsOf(placed));
+  }
+}
+
+TEST_CASE("Grid cells saturate instead of overflowing")
+{
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  const auto infinity = std::numeric_limits<float>::infinity();
+  const auto thirds = RuntimeGridPolicy(0.3f, 3.0f, Axis::x | Axis::z);
+
+  for(const auto cell : {DefaultGrid::toCell(nan), thirds.toCell(nan), RuntimeGridPolicy(0.5f, 3.0f, 0).toCell(nan)})
+  {
+    REQUIRE(cell == 0);
+  }
+
+  constexpr auto limit = std::int32_t{1} << 30;
+  REQUIRE(DefaultGrid::toCell(1e30f) == limit);
+  REQUIRE(DefaultGrid::toCell(-infinity) == -limit);
+  REQUIRE(thirds.toCell(infinity) == limit);
+  REQUIRE(thirds.toCell(-1e30f) == -limit);
+  REQUIRE(DefaultGrid::toCell(1000.0f) == 2000);
+}
+
+TEST_CASE("GridPolicy batches match the scalar path bit for bit")
+{
+  requireBatchMatchesScalar(DefaultGrid());
+  requireBatchMatchesScalar(GridPolicy<std::ratio<3, 10>, std::ratio<3>, Axis::x | Axis::z>());
+  requireBatchMatchesScalar(RuntimeGridPolicy(0.25f, 7.0f, Axis::x | Axis::z));
+  requireBatchMatchesScalar(RuntimeGridPolicy(0.3f, 2.0f, Axis::x | Axis::z));
+}
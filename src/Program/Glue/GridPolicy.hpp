@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <variant>
+
+#include <QVector3D>
+
+#include "snapAndConstrain.hpp"
+
+struct Axis
+{
+  constexpr static unsigned x = 1u << 0;
+  constexpr static unsigned y = 1u << 1;
+  constexpr static unsigned z = 1u << 2;
+};
+
+namespace detail
+{
+  constexpr bool isPowerOfTwo(std::intmax_t value)
+  {
+    return value > 0 && (value & (value - 1)) == 0;
+  }
+
+  template<typename Ratio>
+  constexpr bool isPowerOfTwo()
+  {
+    return (Ratio::num == 1 && isPowerOfTwo(Ratio::den)) || (Ratio::den == 1 && isPowerOfTwo(Ratio::num));
+  }
+
+  template<typename Ratio>
+  constexpr float toFloat()
+  {
+    return static_cast<float>(Ratio::num) / static_cast<float>(Ratio::den);
+  }
+
+  // Converting NaN or a value out of range to an integer is undefined, and axes a policy does not constrain pass any
+  // float through. NaN goes to cell 0, and cells saturate at +-2^30, which leaves the model room to add a brick's
+  // extent or a chunk's reach without overflowing.
+  inline std::int32_t toCellIndex(float rounded)
+  {
+    constexpr auto limit = 1073741824.0f;
+    if(std::isnan(rounded)) return 0;
+    return static_cast<std::int32_t>(std::clamp(rounded, -limit, limit));
+  }
+
+  template<typename Policy>
+  QVector3D snapToGrid(const Policy& policy, QVector3D position)
+  {
+    for(auto axis = 0; axis < 3; ++axis)
+    {
+      if(policy.snaps(axis)) position[axis] = policy.snap(position[axis]);
+    }
+    return position;
+  }
+
+  template<typename Policy>
+  QVector3D constrain(const Policy& policy, QVector3D position)
+  {
+    for(auto axis = 0; axis < 3; ++axis)
+    {
+      if(policy.snaps(axis)) position[axis] = policy.constrain(position[axis]);
+    }
+    return position;
+  }
+} // namespace detail
+
+// Grid with spacing and bound fixed at compile time. Bricks are snapped to multiples of Spacing and kept within
+// [-Bound, Bound] on the axes in SnappedAxes; the other axes are left alone.
+template<typename Spacing, typename Bound, unsigned SnappedAxes>
+class GridPolicy
+{
+public:
+  constexpr static float spacing()
+  {
+    return detail::toFloat<Spacing>();
+  }
+
+  constexpr static float bound()
+  {
+    return detail::toFloat<Bound>();
+  }
+
+  constexpr static bool snaps(int axis)
+  {
+    return (SnappedAxes & (1u << axis)) != 0;
+  }
+
+  static float snap(float value)
+  {
+    if constexpr(powerOfTwoSpacing)
+    {
+      // the reciprocal is exact, so multiplying gives the same result as dividing
+      return std::round(value * detail::toFloat<std::ratio_divide<std::ratio<1>, Spacing>>()) * spacing();
+    }
+    else
+    {
+      return std::round(value / spacing()) * spacing();
+    }
+  }
+
+  static float constrain(float value)
+  {
+    return std::clamp(value, -bound(), bound());
+  }
+
+  // index of the grid line nearest to value
+  static std::int32_t toCell(float value)
+  {
+    if constexpr(powerOfTwoSpacing)
+      return detail::toCellIndex(std::round(value * detail::toFloat<std::ratio_divide<std::ratio<1>, Spacing>>()));
+    else
+      return detail::toCellIndex(std::round(value / spacing()));
+  }
+
+  static float toWorld(std::int32_t cell)
+  {
+    return static_cast<float>(cell) * spacing();
+  }
+
+  static QVector3D snapToGrid(QVector3D position)
+  {
+    return detail::snapToGrid(GridPolicy(), position);
+  }
+
+  static QVector3D constrain(QVector3D position)
+  {
+    return detail::constrain(GridPolicy(), position);
+  }
+
+  // batch version of constrain(snap(value)) for the coordinates of one snapped axis
+  static void snapAndConstrain(float* values, std::size_t count)
+  {
+    if constexpr(powerOfTwoSpacing)
+      snapAndConstrainPowerOfTwo(values, count, spacing(), bound());
+    else
+      ::snapAndConstrain(values, count, spacing(), bound());
+  }
+
+private:
+  constexpr static auto powerOfTwoSpacing = detail::isPowerOfTwo<Spacing>();
+};
+
+using DefaultGrid = GridPolicy<std::ratio<1, 2>, std::ratio<3>, Axis::x | Axis::z>;
+
+// Same interface as GridPolicy, for grids configured by the user at runtime.
+class RuntimeGridPolicy
+{
+public:
+  float spacing() const
+  {
+    return spacing_;
+  }
+
+  float bound() const
+  {
+    return bound_;
+  }
+
+  bool snaps(int axis) const
+  {
+    return (snappedAxes_ & (1u << axis)) != 0;
+  }
+
+  float snap(float value) const;
+  float constrain(float value) const;
+
+  std::int32_t toCell(float value) const;
+  float toWorld(std::int32_t cell) const;
+
+  QVector3D snapToGrid(QVector3D position) const;
+  QVector3D constrain(QVector3D position) const;
+
+  void snapAndConstrain(float* values, std::size_t count) const;
+
+  // Ctor
+public:
+  RuntimeGridPolicy(float spacing, float bound, unsigned snappedAxes);
+
+private:
+  float spacing_;
+  float inverseSpacing_;
+  float bound_;
+  unsigned snappedAxes_;
+  bool powerOfTwoSpacing_;
+};
+
+using Grid = std::variant<DefaultGrid, RuntimeGridPolicy>;
@@ -1,83 +1,424 @@
 #include "ModelAdapter.hpp"
 
+#include "Tracing/Tracing.hpp"
+
 namespace
 {
-  float roundToNearestMultipleOf(float value, float base)
+  QVector3D placeOnGrid(const Grid& grid, const QVector3D& position)
+  {
+    return std::visit([&position](const auto& policy) { return policy.constrain(policy.snapToGrid(position)); },
+                      grid);
+  }
+
+  // Bricks rest on the ground, so the model only stores which cell they occupy.
+  constexpr auto brickRestingHeight = 0.36f;
+  constexpr auto brickHeight = 0.72f;
+
+  model::Cell toCell(const Grid& grid, const QVector3D& position)
   {
-    return std::round(value / base) * base;
+    return std::visit(
+      [&position](const auto& policy) {
+        return model::Cell{policy.toCell(position.x()), policy.toCell(position.z())};
+      },
+      grid);
   }
 
-  QVector3D snapToGrid(QVector3D newPosition)
+  QVector3D toWorld(const Grid& grid, model::Cell cell)
   {
-    constexpr static auto gridSpacing = 0.5f;
+    return std::visit(
+      [cell](const auto& policy) {
+        return QVector3D(policy.toWorld(cell.x), brickRestingHeight, policy.toWorld(cell.z));
+      },
+      grid);
+  }
 
-    newPosition.setX(roundToNearestMultipleOf(newPosition.x(), gridSpacing));
-    newPosition.setZ(roundToNearestMultipleOf(newPosition.z(), gridSpacing));
+  // footprint of the brick mesh in world units, length along x
+  constexpr auto brickLength = 2.0f;
+  constexpr auto brickWidth = 1.0f;
 
-    return newPosition;
+  model::BrickShape brickShapeOn(const Grid& grid)
+  {
+    return std::visit(
+      [](const auto& policy) {
+        return model::BrickShape{std::max(1, policy.toCell(brickLength)), std::max(1, policy.toCell(brickWidth))};
+      },
+      grid);
   }
 
-  QVector3D constrain(QVector3D newPosition)
+  ui::ChunkId toChunkId(model::Chunk chunk)
   {
-    constexpr static auto maxPos = 3.0f;
+    return (std::uint64_t{static_cast<std::uint32_t>(chunk.x)} << 32) | static_cast<std::uint32_t>(chunk.z);
+  }
 
-    newPosition.setX(std::clamp(newPosition.x(), -maxPos, maxPos));
-    newPosition.setZ(std::clamp(newPosition.z(), -maxPos, maxPos));
+  model::Chunk toChunk(ui::ChunkId id)
+  {
+    return {static_cast<std::int32_t>(id >> 32), static_cast<std::int32_t>(id)};
+  }
 
-    return newPosition;
+  model::QuarterTurn toQuarterTurn(float yRotation)
+  {
+    const auto quarters = static_cast<int>(std::round(yRotation / 90.0f)) % 4;
+    return static_cast<model::QuarterTurn>(quarters < 0 ? quarters + 4 : quarters);
+  }
+
+  float toYRotation(model::QuarterTurn rotation)
+  {
+    return 90.0f * static_cast<float>(static_cast<int>(rotation));
+  }
+
+  // the model never lists a slot without a change
+  ui::ChangeKind toChangeKind(model::ChangeKind kind)
+  {
+    switch(kind)
+    {
+    case model::ChangeKind::Inserted: return ui::ChangeKind::Inserted;
+    case model::ChangeKind::Removed: return ui::ChangeKind::Removed;
+    case model::ChangeKind::None:
+    case model::ChangeKind::Updated: break;
+    }
+    return ui::ChangeKind::Updated;
   }
 } // namespace
 
-void ModelEntityAdapter::moveTo(const QVector3D& newPosition)
+ModelAdapter::ModelAdapter(model::Model model, Grid grid) :
+  model_(std::move(model)),
+  grid_(std::move(grid))
+{
+  if(model_.size() == 0) model_.setShape(model::BrickType::Brick2x1, brickShapeOn(grid_));
+}
+
+std::vector<ui::EntityHandle> ModelAdapter::entities() const
+{
+  auto handles = std::vector<ui::EntityHandle>();
+  handles.reserve(model_.size());
+
+  for(auto slot = model::Slot{0}; slot < model_.slotCount(); ++slot)
+  {
+    if(model_.contains(slot)) handles.push_back(slot);
+  }
+
+  return handles;
+}
+
+void ModelAdapter::moveTo(ui::EntityHandle handle, const QVector3D& newPosition)
+{
+  TRACE_ZONE("model", "moveTo");
+  const auto cell = toCell(grid_, placeOnGrid(grid_, newPosition));
+  if(cell != model_.cell(handle)) model_.moveTo(handle, cell);
+  announceChanges();
+}
+
+void ModelAdapter::rotate(ui::EntityHandle handle)
+{
+  TRACE_ZONE("model", "rotate");
+  model_.rotateTo(handle, model::rotatedByQuarter(model_.rotation(handle)));
+  announceChanges();
+}
+
+QVector3D ModelAdapter::position(ui::EntityHandle handle) const
+{
+  return toWorld(grid_, model_.cell(handle));
+}
+
+float ModelAdapter::yRotation(ui::EntityHandle handle) const
+{
+  return toYRotation(model_.rotation(handle));
+}
+
+int ModelAdapter::quarterTurns(ui::EntityHandle handle) const
+{
+  return static_cast<int>(model_.rotation(handle));
+}
+
+std::optional<ui::PickResult> ModelAdapter::pick(const QVector3D& origin, const QVector3D& direction) const
+{
+  // The model measures x and z in cells and y from the bottom of the bricks. Scaling the direction along with the
+  // origin keeps the distance along the ray the same in both frames.
+  const auto spacing = std::visit([](const auto& policy) { return policy.spacing(); }, grid_);
+  const auto bottom = brickRestingHeight - 0.5f * brickHeight;
+  const auto ray = model::Ray{{origin.x() / spacing, origin.y() - bottom, origin.z() / spacing},
+                              {direction.x() / spacing, direction.y(), direction.z() / spacing}};
+
+  const auto hit = model_.pick(ray, brickHeight);
+  if(!hit) return std::nullopt;
+
+  return ui::PickResult{hit->slot, origin + hit->distance * direction};
+}
+
+std::vector<ui::ChunkBounds> ModelAdapter::chunks() const
+{
+  // cell {x, z} spans [x, x + 1) * spacing, see pick()
+  const auto spacing = std::visit([](const auto& policy) { return policy.spacing(); }, grid_);
+  const auto bottom = brickRestingHeight - 0.5f * brickHeight;
+
+  const auto corner = [spacing](model::Cell cell, float y) {
+    return QVector3D(static_cast<float>(cell.x) * spacing, y, static_cast<float>(cell.z) * spacing);
+  };
+
+  auto bounds = std::vector<ui::ChunkBounds>();
+  for(const auto chunk : model_.chunks().chunks())
+  {
+    const auto cells = model_.chunkBounds(chunk);
+    bounds.push_back({toChunkId(chunk),
+                      corner(cells.min, bottom),
+                      corner(cells.max, bottom + brickHeight),
+                      model_.chunks().slotsIn(chunk).size()});
+  }
+  return bounds;
+}
+
+std::vector<ui::EntityHandle> ModelAdapter::entitiesIn(ui::ChunkId chunk) const
+{
+  return model_.chunks().slotsIn(toChunk(chunk));
+}
+
+ui::ChunkId ModelAdapter::chunkOf(ui::EntityHandle handle) const
+{
+  return toChunkId(model::ChunkIndex::chunkOf(model_.cell(handle)));
+}
+
+std::optional<ui::EntityHandle> ModelAdapter::add(const QVector3D& position, float yRotation)
 {
-  position_ = constrain(snapToGrid(newPosition));
-  emit dataChanged();
+  TRACE_ZONE("model", "add");
+  const auto slot = model_.add(toCell(grid_, placeOnGrid(grid_, position)), toQuarterTurn(yRotation));
+  announceChanges();
+  return slot;
 }
 
-void ModelEntityAdapter::rotate()
+void ModelAdapter::remove(ui::EntityHandle handle)
 {
-  yRotation_ += 90;
-  if(yRotation_ > 360.f) yRotation_ -= 360.f;
-  emit dataChanged();
+  TRACE_ZONE("model", "remove");
+  model_.remove(handle);
+  announceChanges();
 }
 
-QVector3D ModelEntityAdapter::position() const
+void ModelAdapter::moveMany(const std::vector<ui::EntityHandle>& handles, const std::vector<QVector3D>& newPositions)
 {
-  return position_;
+  TRACE_ZONE("model", "moveMany");
+  assert(handles.size() == newPositions.size());
+
+  auto placed = newPositions;
+  std::visit(
+    [&placed](const auto& grid) {
+      auto coordinates = std::vector<float>(placed.size());
+      for(auto axis = 0; axis < 3; ++axis)
+      {
+        if(!grid.snaps(axis)) continue;
+
+        for(auto i = std::size_t{0}; i < placed.size(); ++i) coordinates[i] = placed[i][axis];
+        grid.snapAndConstrain(coordinates.data(), coordinates.size());
+        for(auto i = std::size_t{0}; i < placed.size(); ++i) placed[i][axis] = coordinates[i];
+      }
+    },
+    grid_);
+
+  auto cells = std::vector<model::Cell>(placed.size());
+  for(auto i = std::size_t{0}; i < placed.size(); ++i)
+  {
+    cells[i] = toCell(grid_, placed[i]);
+  }
+
+  model_.moveMany(handles, cells);
+  announceChanges();
 }
 
-float ModelEntityAdapter::yRotation() const
+void ModelAdapter::rotateMany(const std::vector<ui::EntityHandle>& handles)
 {
-  return yRotation_;
+  TRACE_ZONE("model", "rotateMany");
+  model_.rotateMany(handles);
+  announceChanges();
+}
+
+void ModelAdapter::flushChanges()
+{
+  TRACE_ZONE("model", "flushChanges");
+  changesAnnounced_ = false;
+  const auto changes = model_.takeChanges();
+  if(changes.empty()) return;
+  TRACE_COUNTER("changed bricks", changes.size());
+
+  auto entityChanges = std::vector<ui::EntityChange>();
+  entityChanges.reserve(changes.size());
+  for(const auto& change : changes) entityChanges.push_back({change.slot, toChangeKind(change.kind)});
+
+  emit entitiesChanged(entityChanges);
+}
+
+void ModelAdapter::announceChanges()
+{
+  if(changesAnnounced_ || !model_.hasChanges()) return;
+
+  changesAnnounced_ = true;
+  emit changesPending();
 }
 
 #include <doctest/doctest.hpp>
 
-TEST_CASE("snapToGrid")
+TEST_CASE("MoveTo writes through to the model")
+{
+  auto model = model::Model();
+  const auto slot = *model.add({0, 0}, model::QuarterTurn::Deg0);
+  auto adapter = ModelAdapter(model);
+  auto entity = adapter.entity(slot);
+
+  entity.moveTo({1.3f, 0.36f, -5.0f});
+  REQUIRE(adapter.position(slot) == QVector3D{1.5f, 0.36f, -3.0f});
+  REQUIRE(entity.position() == QVector3D{1.5f, 0.36f, -3.0f});
+  static_assert(sizeof(entity) <= 2 * sizeof(void*));
+}
+
+TEST_CASE("ModelAdapter handles")
+{
+  auto adapter = ModelAdapter(model::Model());
+
+  const auto first = *adapter.add({0.0f, 0.36f, 0.0f}, 0.0f);
+  const auto second = *adapter.add({2.5f, 0.36f, 1.0f}, 90.0f);
+  REQUIRE(!adapter.add({0.5f, 0.36f, 0.0f}, 0.0f));
+  REQUIRE(adapter.entities() == std::vector<ui::EntityHandle>{first, second});
+  REQUIRE(adapter.entity(first).handle() == first);
+  REQUIRE(adapter.entity(second).yRotation() == 90.0f);
+
+  adapter.remove(first);
+  REQUIRE(adapter.entities() == std::vector<ui::EntityHandle>{second});
+  REQUIRE(adapter.add({-2.0f, 0.36f, -2.0f}, 0.0f) == first);
+  REQUIRE(adapter.entity(first).position() == QVector3D{-2.0f, 0.36f, -2.0f});
+}
+
+TEST_CASE("ModelAdapter with a runtime grid")
+{
+  auto adapter = ModelAdapter(model::Model(), RuntimeGridPolicy(2.0f, 10.0f, Axis::x | Axis::z));
+  const auto handle = *adapter.add({2.9f, 0.36f, -30.0f}, 0.0f);
+  REQUIRE(adapter.entity(handle).position() == QVector3D{2.0f, 0.36f, -10.0f});
+
+  adapter.moveMany({handle}, {{5.1f, 0.36f, 0.9f}});
+  REQUIRE(adapter.entity(handle).position() == QVector3D{6.0f, 0.36f, 0.0f});
+}
+
+TEST_CASE("ModelAdapter batch mutations")
 {
-  REQUIRE(snapToGrid({0.0f, 0.0f, 0.0f}) == QVector3D{0.0f, 0.0f, 0.0f});
-  REQUIRE(snapToGrid({0.3f, 0.0f, 0.0f}) == QVector3D{0.5f, 0.0f, 0.0f});
-  REQUIRE(snapToGrid({0.6f, 0.0f, 0.0f}) == QVector3D{0.5f, 0.0f, 0.0f});
-  REQUIRE(snapToGrid({0.25f, 0.0f, 0.0f}) == QVector3D{0.5f, 0.0f, 0.0f});
-  REQUIRE(snapToGrid({0.0f, 0.0f, 0.3f}) == QVector3D{0.0f, 0.0f, 0.5f});
-  REQUIRE(snapToGrid({0.0f, 0.0f, 0.6f}) == QVector3D{0.0f, 0.0f, 0.5f});
+  auto adapter = ModelAdapter(model::Model());
+  const auto first = *adapter.add({0.0f, 0.36f, 0.0f}, 0.0f);
+  const auto second = *adapter.add({0.0f, 0.36f, 2.0f}, 270.0f);
+
+  adapter.moveMany({first, second}, {{0.3f, 0.36f, 0.0f}, {-5.0f, 0.36f, 1.1f}});
+  REQUIRE(adapter.entity(first).position() == QVector3D{0.5f, 0.36f, 0.0f});
+  REQUIRE(adapter.entity(second).position() == QVector3D{-3.0f, 0.36f, 1.0f});
+
+  // overlapping targets leave every brick where it was
+  adapter.moveMany({first, second}, {{0.0f, 0.36f, 0.0f}, {0.5f, 0.36f, 0.0f}});
+  REQUIRE(adapter.entity(first).position() == QVector3D{0.5f, 0.36f, 0.0f});
+
+  adapter.rotateMany({first, second});
+  REQUIRE(adapter.entity(first).yRotation() == 90.0f);
+  REQUIRE(adapter.entity(second).yRotation() == 0.0f);
 }
 
-TEST_CASE("constrain")
+TEST_CASE("ModelAdapter flushes each changed brick once")
 {
-  REQUIRE(constrain({0.0f, 0.0f, 0.0f}) == QVector3D{0.0f, 0.0f, 0.0f});
-  REQUIRE(constrain({5.0f, 0.0f, 0.0f}) == QVector3D{3.0f, 0.0f, 0.0f});
-  REQUIRE(constrain({0.0f, 0.0f, 5.0f}) == QVector3D{0.0f, 0.0f, 3.0f});
-  REQUIRE(constrain({-5.0f, 0.0f, 0.0f}) == QVector3D{-3.0f, 0.0f, 0.0f});
-  REQUIRE(constrain({0.0f, 0.0f, -5.0f}) == QVector3D{0.0f, 0.0f, -3.0f});
-  REQUIRE(constrain({5.0f, 0.0f, -5.0f}) == QVector3D{3.0f, 0.0f, -3.0f});
+  using Changes = std::vector<ui::EntityChange>;
+
+  auto adapter = ModelAdapter(model::Model());
+  const auto first = *adapter.add({0.0f, 0.36f, 0.0f}, 0.0f);
+  const auto second = *adapter.add({0.0f, 0.36f, 2.0f}, 0.0f);
+
+  auto flushed = std::vector<Changes>();
+  QObject::connect(&adapter, &ui::IModel::entitiesChanged, [&flushed](const Changes& changes) {
+    flushed.push_back(changes);
+  });
+
+  adapter.flushChanges();
+  REQUIRE(flushed == std::vector<Changes>{{{first, ui::ChangeKind::Inserted}, {second, ui::ChangeKind::Inserted}}});
+
+  // several mouse moves within one frame
+  for(const auto x : {0.5f, 1.0f, 1.5f, 2.0f}) adapter.entity(second).moveTo({x, 0.36f, 2.0f});
+  adapter.entity(second).rotate();
+  adapter.flushChanges();
+  adapter.flushChanges();
+  REQUIRE(flushed.size() == 2);
+  REQUIRE(flushed.back() == Changes{{second, ui::ChangeKind::Updated}});
+  REQUIRE(adapter.entity(second).position() == QVector3D{2.0f, 0.36f, 2.0f});
+
+  adapter.remove(first);
+  adapter.flushChanges();
+  REQUIRE(flushed.back() == Changes{{first, ui::ChangeKind::Removed}});
+}
+
+TEST_CASE("ModelAdapter announces pending changes once per flush")
+{
+  auto adapter = ModelAdapter(model::Model());
+  const auto brick = *adapter.add({0.0f, 0.36f, 0.0f}, 0.0f);
+  adapter.flushChanges();
+
+  auto announcements = 0;
+  QObject::connect(&adapter, &ui::IModel::changesPending, [&announcements] { ++announcements; });
+
+  // a move within the cell changes nothing
+  adapter.moveTo(brick, {0.1f, 0.36f, 0.0f});
+  REQUIRE(announcements == 0);
+
+  adapter.moveTo(brick, {1.0f, 0.36f, 0.0f});
+  adapter.rotate(brick);
+  REQUIRE(announcements == 1);
+
+  adapter.flushChanges();
+  adapter.moveTo(brick, {2.0f, 0.36f, 0.0f});
+  REQUIRE(announcements == 2);
+}
+
+TEST_CASE("ModelAdapter picking")
+{
+  auto adapter = ModelAdapter(model::Model());
+  const auto first = *adapter.add({0.0f, 0.36f, 0.0f}, 0.0f);
+  const auto second = *adapter.add({3.0f, 0.36f, 0.0f}, 90.0f);
+
+  const auto top = adapter.pick({0.8f, 10.0f, 0.3f}, {0.0f, -1.0f, 0.0f});
+  REQUIRE(top);
+  REQUIRE(top->handle == first);
+  REQUIRE((top->position - QVector3D{0.8f, 0.72f, 0.3f}).length() < 1e-5f);
+
+  REQUIRE(!adapter.pick({1.2f, 10.0f, 0.3f}, {0.0f, -1.0f, 0.0f}));
+
+  const auto side = adapter.pick({10.0f, 0.2f, 0.9f}, {-2.0f, 0.0f, 0.0f});
+  REQUIRE(side);
+  REQUIRE(side->handle == second);
+  REQUIRE((side->position - QVector3D{3.5f, 0.2f, 0.9f}).length() < 1e-5f);
+}
+
+TEST_CASE("ModelAdapter chunks")
+{
+  auto adapter = ModelAdapter(model::Model());
+  const auto first = *adapter.add({0.0f, 0.36f, 0.0f}, 0.0f);
+  const auto second = *adapter.add({-3.0f, 0.36f, 2.0f}, 90.0f);
+
+  const auto chunks = adapter.chunks();
+  REQUIRE(chunks.size() == 2);
+  for(const auto& chunk : chunks)
+  {
+    REQUIRE(chunk.entityCount == 1);
+    for(const auto handle : adapter.entitiesIn(chunk.id))
+    {
+      REQUIRE(adapter.chunkOf(handle) == chunk.id);
+
+      const auto position = adapter.position(handle);
+      REQUIRE(position.x() - 1.0f >= chunk.min.x());
+      REQUIRE(position.x() + 1.0f <= chunk.max.x());
+      REQUIRE(position.z() - 1.0f >= chunk.min.z());
+      REQUIRE(position.z() + 1.0f <= chunk.max.z());
+      REQUIRE(chunk.min.y() == 0.0f);
+      REQUIRE(chunk.max.y() == 0.72f);
+    }
+  }
+  REQUIRE(adapter.chunkOf(first) != adapter.chunkOf(second));
 }
 
 TEST_CASE("Rotate")
 {
-  auto entity = ModelEntityAdapter({0.0f, 0.0f, 0.0f}, 0.0f);
+  auto adapter = ModelAdapter(model::Model());
+  auto entity = adapter.entity(*adapter.add({0.0f, 0.36f, 0.0f}, 0.0f));
   REQUIRE(entity.yRotation() == 0.0f);
   REQUIRE((entity.rotate(), entity.yRotation()) == 90.0f);
   REQUIRE((entity.rotate(), entity.yRotation()) == 180.0f);
   REQUIRE((entity.rotate(), entity.yRotation()) == 270.0f);
+  REQUIRE(adapter.quarterTurns(entity.handle()) == 3);
+  REQUIRE((entity.rotate(), adapter.quarterTurns(entity.handle())) == 0);
 }
\ No newline at end of file
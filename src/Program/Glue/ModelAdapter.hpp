@@ -1,43 +1,54 @@
 #pragma once
+#include <cassert>
 #include <iostream>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include <QVector3D>
 #include <qobjectdefs.h>
 
+#include "GridPolicy.hpp"
 #include "Model/Model.hpp"
 #include "UI/IModel.hpp"
 
-class ModelEntityAdapter : public ui::IModelEntity
+class ModelAdapter : public ui::IModel
 {
   Q_OBJECT;
 
 public:
-  void moveTo(const QVector3D& newPosition) override;
-  void rotate() override;
+  std::vector<ui::EntityHandle> entities() const override;
 
-  QVector3D position() const override;
-  float yRotation() const override;
+  void moveTo(ui::EntityHandle handle, const QVector3D& newPosition) override;
+  void rotate(ui::EntityHandle handle) override;
 
-  // Ctor
-public:
-  ModelEntityAdapter(QVector3D position, float yRotation) : position_(std::move(position)), yRotation_(yRotation) {}
+  QVector3D position(ui::EntityHandle handle) const override;
+  float yRotation(ui::EntityHandle handle) const override;
+  int quarterTurns(ui::EntityHandle handle) const override;
 
-private:
-  QVector3D position_;
-  float yRotation_{};
-};
+  std::optional<ui::PickResult> pick(const QVector3D& origin, const QVector3D& direction) const override;
 
-class ModelAdapter : public ui::IModel
-{
-public:
-  ModelAdapter(model::Model model) : model_(std::move(model)) {}
+  std::vector<ui::ChunkBounds> chunks() const override;
+  std::vector<ui::EntityHandle> entitiesIn(ui::ChunkId chunk) const override;
+  ui::ChunkId chunkOf(ui::EntityHandle handle) const override;
+
+  std::optional<ui::EntityHandle> add(const QVector3D& position, float yRotation) override;
+  void remove(ui::EntityHandle handle) override;
 
-  std::shared_ptr<ui::IModelEntity> get() const override
-  {
-    return std::make_shared<ModelEntityAdapter>(QVector3D(0.0f, 0.36f, 0.0f), 0.0f);
-  }
+  void moveMany(const std::vector<ui::EntityHandle>& handles, const std::vector<QVector3D>& newPositions) override;
+  void rotateMany(const std::vector<ui::EntityHandle>& handles) override;
+
+  void flushChanges() override;
+
+  // Ctor
+public:
+  ModelAdapter(model::Model model, Grid grid = DefaultGrid());
 
 private:
+  void announceChanges();
+
+  // handles are the model's slots, so the adapter keeps no per-brick state
   model::Model model_;
+  Grid grid_;
+  bool changesAnnounced_{};
 };
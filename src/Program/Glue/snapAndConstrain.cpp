@@ -0,0 +1,121 @@
+#include "snapAndConstrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define SNAP_USE_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define SNAP_USE_SSE2
+#endif
+
+namespace
+{
+  template<bool byReciprocal>
+  float snapAndConstrainScalar(float value, float gridSpacing, float inverseSpacing, float maxPos)
+  {
+    const auto cells = byReciprocal ? value * inverseSpacing : value / gridSpacing;
+    return std::clamp(std::round(cells) * gridSpacing, -maxPos, maxPos);
+  }
+
+  // Values from 2^23 upwards have no fractional part, so they (and inf/NaN) are passed through unrounded.
+  constexpr auto firstIntegralOnlyFloat = 8388608.0f;
+
+#if defined(SNAP_USE_AVX)
+  // std::round: half away from zero, keeps the sign of zero
+  __m256 round(__m256 x)
+  {
+    const auto signMask = _mm256_set1_ps(-0.0f);
+    const auto sign = _mm256_and_ps(signMask, x);
+
+    auto rounded = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(x));
+    const auto fraction = _mm256_andnot_ps(signMask, _mm256_sub_ps(x, rounded));
+    const auto awayFromZero = _mm256_cmp_ps(fraction, _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    rounded = _mm256_add_ps(rounded, _mm256_and_ps(awayFromZero, _mm256_or_ps(sign, _mm256_set1_ps(1.0f))));
+    rounded = _mm256_or_ps(rounded, sign);
+
+    const auto hasFraction =
+      _mm256_cmp_ps(_mm256_andnot_ps(signMask, x), _mm256_set1_ps(firstIntegralOnlyFloat), _CMP_LT_OQ);
+    return _mm256_blendv_ps(x, rounded, hasFraction);
+  }
+
+  template<bool byReciprocal>
+  __m256 snapAndConstrain(__m256 values, __m256 gridSpacing, __m256 inverseSpacing, __m256 minPos, __m256 maxPos)
+  {
+    const auto cells = byReciprocal ? _mm256_mul_ps(values, inverseSpacing) : _mm256_div_ps(values, gridSpacing);
+    const auto snapped = _mm256_mul_ps(round(cells), gridSpacing);
+    // operand order matches std::clamp, so NaN stays NaN
+    return _mm256_min_ps(maxPos, _mm256_max_ps(minPos, snapped));
+  }
+#elif defined(SNAP_USE_SSE2)
+  // std::round: half away from zero, keeps the sign of zero
+  __m128 round(__m128 x)
+  {
+    const auto signMask = _mm_set1_ps(-0.0f);
+    const auto sign = _mm_and_ps(signMask, x);
+
+    auto rounded = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    const auto fraction = _mm_andnot_ps(signMask, _mm_sub_ps(x, rounded));
+    const auto awayFromZero = _mm_cmpge_ps(fraction, _mm_set1_ps(0.5f));
+    rounded = _mm_add_ps(rounded, _mm_and_ps(awayFromZero, _mm_or_ps(sign, _mm_set1_ps(1.0f))));
+    rounded = _mm_or_ps(rounded, sign);
+
+    const auto hasFraction = _mm_cmplt_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(firstIntegralOnlyFloat));
+    return _mm_or_ps(_mm_and_ps(hasFraction, rounded), _mm_andnot_ps(hasFraction, x));
+  }
+
+  template<bool byReciprocal>
+  __m128 snapAndConstrain(__m128 values, __m128 gridSpacing, __m128 inverseSpacing, __m128 minPos, __m128 maxPos)
+  {
+    const auto cells = byReciprocal ? _mm_mul_ps(values, inverseSpacing) : _mm_div_ps(values, gridSpacing);
+    const auto snapped = _mm_mul_ps(round(cells), gridSpacing);
+    // operand order matches std::clamp, so NaN stays NaN
+    return _mm_min_ps(maxPos, _mm_max_ps(minPos, snapped));
+  }
+#endif
+
+  template<bool byReciprocal>
+  void snapAndConstrainAll(float* values, std::size_t count, float gridSpacing, float maxPos)
+  {
+    const auto inverseSpacing = 1.0f / gridSpacing;
+    auto i = std::size_t{0};
+
+#if defined(SNAP_USE_AVX)
+    const auto spacing8 = _mm256_set1_ps(gridSpacing);
+    const auto inverse8 = _mm256_set1_ps(inverseSpacing);
+    const auto min8 = _mm256_set1_ps(-maxPos);
+    const auto max8 = _mm256_set1_ps(maxPos);
+    for(; i + 8 <= count; i += 8)
+    {
+      const auto snapped = snapAndConstrain<byReciprocal>(_mm256_loadu_ps(values + i), spacing8, inverse8, min8, max8);
+      _mm256_storeu_ps(values + i, snapped);
+    }
+#elif defined(SNAP_USE_SSE2)
+    const auto spacing4 = _mm_set1_ps(gridSpacing);
+    const auto inverse4 = _mm_set1_ps(inverseSpacing);
+    const auto min4 = _mm_set1_ps(-maxPos);
+    const auto max4 = _mm_set1_ps(maxPos);
+    for(; i + 4 <= count; i += 4)
+    {
+      _mm_storeu_ps(values + i, snapAndConstrain<byReciprocal>(_mm_loadu_ps(values + i), spacing4, inverse4, min4, max4));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+      values[i] = snapAndConstrainScalar<byReciprocal>(values[i], gridSpacing, inverseSpacing, maxPos);
+    }
+  }
+} // namespace
+
+void snapAndConstrain(float* values, std::size_t count, float gridSpacing, float maxPos)
+{
+  snapAndConstrainAll<false>(values, count, gridSpacing, maxPos);
+}
+
+void snapAndConstrainPowerOfTwo(float* values, std::size_t count, float gridSpacing, float maxPos)
+{
+  snapAndConstrainAll<true>(values, count, gridSpacing, maxPos);
+}
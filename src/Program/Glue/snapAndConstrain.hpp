@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+// Snaps every value to the nearest multiple of gridSpacing and clamps it to [-maxPos, maxPos], in place.
+// Results are bit-identical to std::clamp(std::round(value / gridSpacing) * gridSpacing, -maxPos, maxPos).
+void snapAndConstrain(float* values, std::size_t count, float gridSpacing, float maxPos);
+
+// Same as snapAndConstrain, but multiplies by the reciprocal instead of dividing. Only valid, and then bit-identical,
+// when gridSpacing is a power of two.
+void snapAndConstrainPowerOfTwo(float* values, std::size_t count, float gridSpacing, float maxPos);
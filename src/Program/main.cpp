@@ -56,6 +56,7 @@
 int main(int argc, char** argv)
 {
   const auto model = std::make_shared<ModelAdapter>(model::Model());
+  model->add({0.0f, 0.36f, 0.0f}, 0.0f);
 
   return ui::runUI(argc, argv, model);
 }
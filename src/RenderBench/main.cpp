@@ -0,0 +1,191 @@
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include <Qt3DExtras/qt3dwindow.h>
+
+#include <Qt3DLogic/QFrameAction>
+
+#include <Qt3DRender/QCamera>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+#include "BenchSupport/BenchReport.hpp"
+#include "BenchSupport/BrickField.hpp"
+#include "BenchSupport/Options.hpp"
+#include "BenchSupport/ProcessStats.hpp"
+#include "detail/SceneWidget.hpp"
+#include "detail/initializeContent.hpp"
+
+namespace
+{
+  struct FrameSamples
+  {
+    std::vector<double> wallMilliseconds;
+    // The main thread runs the model, the sync and the culling. The other threads are Qt3D's aspect jobs and the
+    // render thread, plus the rasterizer threads of llvmpipe when rendering in software.
+    std::vector<double> mainThreadCpuMilliseconds;
+    std::vector<double> otherThreadsCpuMilliseconds;
+    bool timedOut{};
+  };
+
+  struct FrameClock
+  {
+    double wall{};
+    double process{};
+    double mainThread{};
+  };
+
+  FrameClock readClock(const QElapsedTimer& wallClock)
+  {
+    return {static_cast<double>(wallClock.nsecsElapsed()) / 1e6,
+            bench::processCpuSeconds() * 1e3,
+            bench::threadCpuSeconds() * 1e3};
+  }
+
+  // Renders warmupFrames and then frames more frames, recording each of the latter from one frame action to the
+  // next. The camera orbits a little every frame, which keeps the window rendering and the culler busy.
+  FrameSamples renderFrames(SceneWidget& scene, int warmupFrames, int frames, int timeoutMilliseconds)
+  {
+    auto samples = FrameSamples();
+    auto loop = QEventLoop();
+
+    auto wallClock = QElapsedTimer();
+    wallClock.start();
+    auto previous = readClock(wallClock);
+    auto frame = 0;
+
+    auto* camera = scene.view()->camera();
+    auto* frameAction = new Qt3DLogic::QFrameAction();
+    QObject::connect(frameAction, &Qt3DLogic::QFrameAction::triggered, &loop, [&](float /*dt*/) {
+      const auto now = readClock(wallClock);
+      if(frame > warmupFrames)
+      {
+        const auto processCpu = now.process - previous.process;
+        const auto mainThreadCpu = now.mainThread - previous.mainThread;
+        samples.wallMilliseconds.push_back(now.wall - previous.wall);
+        samples.mainThreadCpuMilliseconds.push_back(mainThreadCpu);
+        samples.otherThreadsCpuMilliseconds.push_back(processCpu - mainThreadCpu);
+      }
+      previous = now;
+
+      camera->panAboutViewCenter(0.5f);
+      if(++frame > warmupFrames + frames) loop.quit();
+    });
+    scene.rootEntity()->addComponent(frameAction);
+
+    QTimer::singleShot(timeoutMilliseconds, &loop, [&loop, &samples] {
+      samples.timedOut = true;
+      loop.quit();
+    });
+    loop.exec();
+
+    scene.rootEntity()->removeComponent(frameAction);
+    delete frameAction;
+    return samples;
+  }
+
+  QJsonObject withSummary(const std::vector<double>& samples)
+  {
+    return QJsonObject{{QStringLiteral("summary"), bench::toJson(bench::summarize(samples))},
+                       {QStringLiteral("samples"), bench::toJson(samples)}};
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  bench::preferHeadlessRendering();
+
+  QApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QStringLiteral("Renders scenes of increasing size and reports the frame times."));
+  parser.addHelpOption();
+  const auto sizesOption = QCommandLineOption(QStringLiteral("sizes"),
+                                              QStringLiteral("Comma separated brick counts."),
+                                              QStringLiteral("counts"),
+                                              QStringLiteral("1,1000,10000,100000"));
+  const auto framesOption = QCommandLineOption(QStringLiteral("frames"),
+                                               QStringLiteral("Frames recorded per scene."),
+                                               QStringLiteral("count"),
+                                               QStringLiteral("200"));
+  const auto warmupOption = QCommandLineOption(QStringLiteral("warmup"),
+                                               QStringLiteral("Frames rendered before recording."),
+                                               QStringLiteral("count"),
+                                               QStringLiteral("20"));
+  const auto timeoutOption = QCommandLineOption(QStringLiteral("timeout"),
+                                                QStringLiteral("Seconds to wait for the frames of one scene."),
+                                                QStringLiteral("seconds"),
+                                                QStringLiteral("600"));
+  const auto outputOption = QCommandLineOption(QStringLiteral("output"),
+                                               QStringLiteral("JSON file to write."),
+                                               QStringLiteral("path"),
+                                               QStringLiteral("render-bench.json"));
+  const auto instancedOption =
+    QCommandLineOption(QStringLiteral("instanced"), QStringLiteral("Draw all bricks with one instanced draw call."));
+  parser.addOptions({sizesOption, framesOption, warmupOption, timeoutOption, outputOption, instancedOption});
+  parser.process(app);
+
+  // Without a context Qt3D renders nothing and the frame actions never run, or run for frames never drawn.
+  const auto renderer = bench::openGLRenderer();
+  if(renderer.isEmpty())
+  {
+    std::cerr << "no OpenGL context could be created on platform " << app.platformName().toStdString()
+              << "; without a display, run under a virtual one, e.g. xvfb-run -a\n";
+    return 1;
+  }
+
+  const auto frames = parser.value(framesOption).toInt();
+  const auto warmupFrames = parser.value(warmupOption).toInt();
+  const auto timeoutMilliseconds = parser.value(timeoutOption).toInt() * 1000;
+  const auto rendering = parser.isSet(instancedOption) ? BrickRendering::Instanced : BrickRendering::EntityPerBrick;
+
+  auto report = bench::reportHeader(QStringLiteral("render"));
+  report[QStringLiteral("platform")] = app.platformName();
+  report[QStringLiteral("openGLRenderer")] = renderer;
+  report[QStringLiteral("rendering")] =
+    rendering == BrickRendering::Instanced ? QStringLiteral("instanced") : QStringLiteral("entity per brick");
+  report[QStringLiteral("frames")] = frames;
+  report[QStringLiteral("warmupFrames")] = warmupFrames;
+
+  auto scenes = QJsonArray();
+  auto timedOut = false;
+  for(const auto size : bench::parseCounts(parser.value(sizesOption)))
+  {
+    std::cerr << "rendering " << size << " bricks\n";
+
+    auto setup = QElapsedTimer();
+    setup.start();
+    auto* scene = new SceneWidget();
+    initializeContent(*scene, bench::makeBrickField(size), rendering);
+    scene->resize(1200, 800);
+    scene->show();
+    const auto setupMilliseconds = static_cast<double>(setup.nsecsElapsed()) / 1e6;
+
+    const auto samples = renderFrames(*scene, warmupFrames, frames, timeoutMilliseconds);
+    delete scene;
+    if(samples.timedOut)
+    {
+      std::cerr << "timed out after " << samples.wallMilliseconds.size() << " of " << frames << " frames\n";
+      timedOut = true;
+    }
+
+    scenes.append(QJsonObject{
+      {QStringLiteral("bricks"), static_cast<double>(size)},
+      {QStringLiteral("setupMs"), setupMilliseconds},
+      {QStringLiteral("timedOut"), samples.timedOut},
+      {QStringLiteral("wallMs"), withSummary(samples.wallMilliseconds)},
+      {QStringLiteral("mainThreadCpuMs"), withSummary(samples.mainThreadCpuMilliseconds)},
+      {QStringLiteral("otherThreadsCpuMs"), withSummary(samples.otherThreadsCpuMilliseconds)},
+      // the high-water mark of the process so far; sizes run in the order given, so list them ascending
+      {QStringLiteral("peakRssBytes"), static_cast<double>(bench::peakResidentBytes())},
+    });
+  }
+  report[QStringLiteral("scenes")] = scenes;
+
+  return bench::writeReport(parser.value(outputOption), report) && !timedOut ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  std::atomic<std::size_t> allocations{0};
+  std::atomic<std::size_t> bytes{0};
+
+  void* allocate(std::size_t size) noexcept
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+  }
+} // namespace
+
+AllocationCounts allocationCounts()
+{
+  return {allocations.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)};
+}
+
+void* operator new(std::size_t size)
+{
+  if(auto* memory = allocate(size)) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  if(auto* memory = allocate(size)) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+  std::free(memory);
+}
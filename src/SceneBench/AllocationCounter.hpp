@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts the calls to the global operator new of this executable, from all threads, since startup. Aligned
+// allocations are not counted.
+struct AllocationCounts
+{
+  std::size_t allocations{};
+  std::size_t bytes{};
+};
+
+AllocationCounts allocationCounts();
+
+inline AllocationCounts operator-(const AllocationCounts& later, const AllocationCounts& earlier)
+{
+  return {later.allocations - earlier.allocations, later.bytes - earlier.bytes};
+}
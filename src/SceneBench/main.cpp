@@ -0,0 +1,209 @@
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <unordered_set>
+
+#include <Qt3DCore/QNode>
+
+#include <Qt3DExtras/qt3dwindow.h>
+
+#include <Qt3DRender/QFrameGraphNode>
+#include <Qt3DRender/QRenderCapture>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+#include "AllocationCounter.hpp"
+#include "BenchSupport/BenchReport.hpp"
+#include "BenchSupport/BrickField.hpp"
+#include "BenchSupport/Options.hpp"
+#include "BenchSupport/ProcessStats.hpp"
+#include "detail/SceneWidget.hpp"
+#include "detail/initializeContent.hpp"
+
+namespace
+{
+  double millisecondsOf(const QElapsedTimer& timer)
+  {
+    return static_cast<double>(timer.nsecsElapsed()) / 1e6;
+  }
+
+  struct Census
+  {
+    std::size_t objects{};
+    std::size_t nodes{};
+    std::map<QString, std::size_t> classes;
+  };
+
+  // Every QObject below the widget and the 3D window. The scene's root entity is listed as well, as the window only
+  // adopts it once shown.
+  Census takeCensus(SceneWidget& scene)
+  {
+    auto seen = std::unordered_set<const QObject*>();
+    auto census = Census();
+    const auto count = [&seen, &census](const QObject* object) {
+      if(!seen.insert(object).second) return;
+
+      ++census.objects;
+      if(qobject_cast<const Qt3DCore::QNode*>(object)) ++census.nodes;
+      ++census.classes[QString::fromLatin1(object->metaObject()->className())];
+    };
+
+    for(const QObject* root : {static_cast<QObject*>(&scene), static_cast<QObject*>(scene.view()), scene.rootEntity()})
+    {
+      count(root);
+      for(const auto* child : root->findChildren<QObject*>()) count(child);
+    }
+    return census;
+  }
+
+  QJsonObject toJson(const Census& census)
+  {
+    auto classes = QJsonObject();
+    for(const auto& [name, count] : census.classes) classes[name] = static_cast<double>(count);
+
+    return QJsonObject{{QStringLiteral("objects"), static_cast<double>(census.objects)},
+                       {QStringLiteral("nodes"), static_cast<double>(census.nodes)},
+                       {QStringLiteral("classes"), classes}};
+  }
+
+  // A render capture at the root of the frame graph completes its reply once a whole frame has been rendered.
+  Qt3DRender::QRenderCaptureReply* captureFirstFrame(SceneWidget& scene)
+  {
+    auto* view = scene.view();
+    auto* frameGraph = view->activeFrameGraph();
+    auto* capture = new Qt3DRender::QRenderCapture();
+    view->setActiveFrameGraph(capture);
+    frameGraph->setParent(capture);
+    return capture->requestCapture();
+  }
+
+  struct SceneCost
+  {
+    double initializeMilliseconds{};
+    AllocationCounts initializeAllocations;
+    double firstFrameMilliseconds{};
+    bool timedOut{};
+    Census census;
+    double teardownMilliseconds{};
+  };
+
+  SceneCost measureScene(std::size_t bricks, BrickRendering rendering, int timeoutMilliseconds)
+  {
+    auto cost = SceneCost();
+    auto model = bench::makeBrickField(bricks);
+
+    auto sinceStart = QElapsedTimer();
+    sinceStart.start();
+    const auto allocationsBefore = allocationCounts();
+
+    auto* scene = new SceneWidget();
+    initializeContent(*scene, model, rendering);
+
+    cost.initializeAllocations = allocationCounts() - allocationsBefore;
+    cost.initializeMilliseconds = millisecondsOf(sinceStart);
+
+    auto loop = QEventLoop();
+    QObject::connect(captureFirstFrame(*scene), &Qt3DRender::QRenderCaptureReply::completed, &loop, &QEventLoop::quit);
+    QTimer::singleShot(timeoutMilliseconds, &loop, [&loop, &cost] {
+      cost.timedOut = true;
+      loop.quit();
+    });
+    scene->resize(1200, 800);
+    scene->show();
+    loop.exec();
+    cost.firstFrameMilliseconds = millisecondsOf(sinceStart);
+
+    cost.census = takeCensus(*scene);
+
+    auto teardown = QElapsedTimer();
+    teardown.start();
+    delete scene;
+    cost.teardownMilliseconds = millisecondsOf(teardown);
+    return cost;
+  }
+
+  double perBrick(std::size_t value, std::size_t baseline, std::size_t bricks)
+  {
+    return (static_cast<double>(value) - static_cast<double>(baseline)) / static_cast<double>(bricks);
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  bench::preferHeadlessRendering();
+
+  QApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+    QStringLiteral("Builds scenes of increasing size and reports what setting them up costs."));
+  parser.addHelpOption();
+  const auto sizesOption = QCommandLineOption(QStringLiteral("sizes"),
+                                              QStringLiteral("Comma separated brick counts."),
+                                              QStringLiteral("counts"),
+                                              QStringLiteral("1,1000,10000,100000"));
+  const auto timeoutOption = QCommandLineOption(QStringLiteral("timeout"),
+                                                QStringLiteral("Seconds to wait for the first frame of a scene."),
+                                                QStringLiteral("seconds"),
+                                                QStringLiteral("600"));
+  const auto outputOption = QCommandLineOption(QStringLiteral("output"),
+                                               QStringLiteral("JSON file to write."),
+                                               QStringLiteral("path"),
+                                               QStringLiteral("scene-bench.json"));
+  const auto instancedOption =
+    QCommandLineOption(QStringLiteral("instanced"), QStringLiteral("Draw all bricks with one instanced draw call."));
+  parser.addOptions({sizesOption, timeoutOption, outputOption, instancedOption});
+  parser.process(app);
+
+  const auto timeoutMilliseconds = parser.value(timeoutOption).toInt() * 1000;
+  const auto rendering = parser.isSet(instancedOption) ? BrickRendering::Instanced : BrickRendering::EntityPerBrick;
+
+  auto report = bench::reportHeader(QStringLiteral("scene"));
+  report[QStringLiteral("platform")] = qEnvironmentVariable("QT_QPA_PLATFORM");
+  report[QStringLiteral("rendering")] =
+    rendering == BrickRendering::Instanced ? QStringLiteral("instanced") : QStringLiteral("entity per brick");
+
+  // what an empty scene costs, so the per brick figures leave out the window, camera and frame graph
+  std::cerr << "empty scene\n";
+  const auto baseline = measureScene(0, rendering, timeoutMilliseconds);
+  report[QStringLiteral("emptyScene")] = QJsonObject{
+    {QStringLiteral("initializeMs"), baseline.initializeMilliseconds},
+    {QStringLiteral("allocations"), static_cast<double>(baseline.initializeAllocations.allocations)},
+    {QStringLiteral("allocatedBytes"), static_cast<double>(baseline.initializeAllocations.bytes)},
+    {QStringLiteral("firstFrameMs"), baseline.firstFrameMilliseconds},
+    {QStringLiteral("census"), toJson(baseline.census)},
+  };
+
+  auto scenes = QJsonArray();
+  for(const auto bricks : bench::parseCounts(parser.value(sizesOption)))
+  {
+    std::cerr << bricks << " bricks\n";
+    const auto cost = measureScene(bricks, rendering, timeoutMilliseconds);
+    const auto& allocations = cost.initializeAllocations;
+
+    scenes.append(QJsonObject{
+      {QStringLiteral("bricks"), static_cast<double>(bricks)},
+      {QStringLiteral("initializeMs"), cost.initializeMilliseconds},
+      {QStringLiteral("allocations"), static_cast<double>(allocations.allocations)},
+      {QStringLiteral("allocatedBytes"), static_cast<double>(allocations.bytes)},
+      {QStringLiteral("allocationsPerBrick"),
+       perBrick(allocations.allocations, baseline.initializeAllocations.allocations, bricks)},
+      {QStringLiteral("allocatedBytesPerBrick"),
+       perBrick(allocations.bytes, baseline.initializeAllocations.bytes, bricks)},
+      {QStringLiteral("firstFrameMs"), cost.firstFrameMilliseconds},
+      {QStringLiteral("timedOut"), cost.timedOut},
+      {QStringLiteral("census"), toJson(cost.census)},
+      {QStringLiteral("objectsPerBrick"), perBrick(cost.census.objects, baseline.census.objects, bricks)},
+      {QStringLiteral("nodesPerBrick"), perBrick(cost.census.nodes, baseline.census.nodes, bricks)},
+      {QStringLiteral("teardownMs"), cost.teardownMilliseconds},
+      {QStringLiteral("peakRssBytes"), static_cast<double>(bench::peakResidentBytes())},
+    });
+  }
+  report[QStringLiteral("scenes")] = scenes;
+
+  return bench::writeReport(parser.value(outputOption), report) ? 0 : 1;
+}
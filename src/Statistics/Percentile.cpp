@@ -0,0 +1,32 @@
+#include "Percentile.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+namespace statistics
+{
+  double percentile(const std::vector<double>& sorted, double fraction)
+  {
+    assert(!sorted.empty());
+    assert(fraction >= 0.0 && fraction <= 1.0);
+
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::clamp(rank, std::size_t{1}, sorted.size()) - 1];
+  }
+} // namespace statistics
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Percentiles use the nearest rank")
+{
+  REQUIRE(statistics::percentile({3.0}, 0.0) == 3.0);
+  REQUIRE(statistics::percentile({3.0}, 0.99) == 3.0);
+
+  const auto samples = std::vector<double>{1.0, 2.0, 3.0, 4.0};
+  REQUIRE(statistics::percentile(samples, 0.0) == 1.0);
+  REQUIRE(statistics::percentile(samples, 0.5) == 2.0);
+  REQUIRE(statistics::percentile(samples, 0.51) == 3.0);
+  REQUIRE(statistics::percentile(samples, 1.0) == 4.0);
+}
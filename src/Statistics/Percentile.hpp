@@ -0,0 +1,10 @@
+#pragma once
+
+#include <vector>
+
+namespace statistics
+{
+  // Nearest rank percentile of ascending samples, so the result is always one of them. fraction is in [0, 1], and
+  // sorted must not be empty.
+  double percentile(const std::vector<double>& sorted, double fraction);
+} // namespace statistics
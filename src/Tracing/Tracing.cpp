@@ -0,0 +1,284 @@
+#include "Tracing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+  enum class Phase : char
+  {
+    Complete = 'X',
+    Counter = 'C',
+  };
+
+  struct Event
+  {
+    const char* category{};
+    const char* name{};
+    std::int64_t begin{};
+    std::int64_t duration{};
+    double value{};
+    Phase phase{};
+  };
+
+  // Written by its thread only. The lock is only ever contended while a trace is started or written.
+  struct ThreadBuffer
+  {
+    void push(const Event& event)
+    {
+      const auto lock = std::lock_guard(mutex);
+      if(events.size() < tracing::eventsPerThread)
+        events.push_back(event);
+      else
+        events[next] = event;
+      next = (next + 1) % tracing::eventsPerThread;
+    }
+
+    std::mutex mutex;
+    std::vector<Event> events; // ring buffer
+    std::size_t next{};
+    std::size_t id{};
+    std::string name;
+  };
+
+  // Buffers outlive their threads, so a trace still holds the events of Qt's finished worker threads.
+  struct Registry
+  {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<bool> recording{false};
+  };
+
+  Registry& registry()
+  {
+    static auto instance = Registry();
+    return instance;
+  }
+
+  ThreadBuffer& threadBuffer()
+  {
+    thread_local const auto buffer = [] {
+      auto& threads = registry();
+      const auto lock = std::lock_guard(threads.mutex);
+      auto created = std::make_shared<ThreadBuffer>();
+      created->id = threads.buffers.size() + 1;
+      threads.buffers.push_back(created);
+      return created;
+    }();
+    return *buffer;
+  }
+
+  // names are literals in the code, so escaping quotes and backslashes is enough
+  void writeString(std::ostream& out, const char* text)
+  {
+    out << '"';
+    for(auto* c = text; *c; ++c)
+    {
+      if(*c == '"' || *c == '\\') out << '\\';
+      out << *c;
+    }
+    out << '"';
+  }
+
+  // Chrome traces count in microseconds
+  double microseconds(std::int64_t nanoseconds)
+  {
+    return static_cast<double>(nanoseconds) / 1000.0;
+  }
+
+  void writeEvent(std::ostream& out, std::size_t thread, const Event& event)
+  {
+    out << "{\"name\":";
+    writeString(out, event.name);
+    out << ",\"ph\":\"" << static_cast<char>(event.phase) << "\",\"pid\":1,\"tid\":" << thread
+        << ",\"ts\":" << microseconds(event.begin);
+    if(event.phase == Phase::Complete)
+    {
+      out << ",\"cat\":";
+      writeString(out, event.category);
+      out << ",\"dur\":" << microseconds(event.duration);
+    }
+    else
+    {
+      out << ",\"args\":{\"value\":" << event.value << '}';
+    }
+    out << '}';
+  }
+} // namespace
+
+namespace tracing
+{
+  void start()
+  {
+    auto& threads = registry();
+    const auto lock = std::lock_guard(threads.mutex);
+    for(const auto& buffer : threads.buffers)
+    {
+      const auto bufferLock = std::lock_guard(buffer->mutex);
+      buffer->events.clear();
+      buffer->next = 0;
+    }
+    threads.recording = true;
+  }
+
+  void stop()
+  {
+    registry().recording = false;
+  }
+
+  bool recording()
+  {
+    return registry().recording.load(std::memory_order_relaxed);
+  }
+
+  void nameThread(const char* name)
+  {
+    auto& buffer = threadBuffer();
+    const auto lock = std::lock_guard(buffer.mutex);
+    buffer.name = name;
+  }
+
+  std::int64_t now()
+  {
+    using namespace std::chrono;
+    static const auto epoch = steady_clock::now();
+    return duration_cast<nanoseconds>(steady_clock::now() - epoch).count();
+  }
+
+  void complete(const char* category, const char* name, std::int64_t begin, std::int64_t end)
+  {
+    if(!recording()) return;
+    threadBuffer().push({category, name, begin, end - begin, 0.0, Phase::Complete});
+  }
+
+  void counter(const char* name, double value)
+  {
+    if(!recording()) return;
+    threadBuffer().push({"", name, now(), 0, value, Phase::Counter});
+  }
+
+  void writeChromeTrace(std::ostream& out)
+  {
+    auto& threads = registry();
+    const auto lock = std::lock_guard(threads.mutex);
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    auto separator = "\n";
+    for(const auto& buffer : threads.buffers)
+    {
+      const auto bufferLock = std::lock_guard(buffer->mutex);
+      if(!buffer->name.empty())
+      {
+        out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":";
+        writeString(out, buffer->name.c_str());
+        out << "}}";
+        separator = ",\n";
+      }
+
+      const auto& events = buffer->events;
+      const auto oldest = events.size() < eventsPerThread ? 0 : buffer->next;
+      for(auto i = std::size_t{0}; i < events.size(); ++i)
+      {
+        out << separator;
+        writeEvent(out, buffer->id, events[(oldest + i) % events.size()]);
+        separator = ",\n";
+      }
+    }
+    out << "\n]}\n";
+  }
+
+  bool writeChromeTrace(const std::string& path)
+  {
+    auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if(!file)
+    {
+      std::cerr << "cannot write " << path << '\n';
+      return false;
+    }
+
+    writeChromeTrace(file);
+    return static_cast<bool>(file);
+  }
+} // namespace tracing
+
+#include <sstream>
+#include <thread>
+
+#include <doctest/doctest.hpp>
+
+namespace
+{
+  std::size_t occurrences(const std::string& text, const std::string& part)
+  {
+    auto count = std::size_t{0};
+    for(auto at = text.find(part); at != std::string::npos; at = text.find(part, at + part.size())) ++count;
+    return count;
+  }
+
+  std::string chromeTrace()
+  {
+    auto out = std::ostringstream();
+    tracing::writeChromeTrace(out);
+    return out.str();
+  }
+} // namespace
+
+TEST_CASE("Tracing records zones and counters per thread")
+{
+  tracing::start();
+  tracing::nameThread("test main");
+  {
+    const auto zone = tracing::Zone("test", "outer zone");
+    const auto nested = tracing::Zone("test", "inner zone");
+    tracing::counter("test counter", 42.0);
+  }
+  std::thread([] {
+    tracing::nameThread("test worker");
+    const auto zone = tracing::Zone("test", "worker zone");
+  }).join();
+  tracing::stop();
+
+  {
+    const auto ignored = tracing::Zone("test", "zone while stopped");
+  }
+
+  const auto trace = chromeTrace();
+  REQUIRE(trace.find("\"traceEvents\":[") != std::string::npos);
+  REQUIRE(occurrences(trace, "\"name\":\"outer zone\",\"ph\":\"X\"") == 1);
+  REQUIRE(occurrences(trace, "\"name\":\"inner zone\",\"ph\":\"X\"") == 1);
+  REQUIRE(occurrences(trace, "\"name\":\"test counter\",\"ph\":\"C\"") == 1);
+  REQUIRE(occurrences(trace, "\"args\":{\"value\":42.000}") == 1);
+  REQUIRE(occurrences(trace, "\"name\":\"test worker\"") == 1);
+  REQUIRE(occurrences(trace, "zone while stopped") == 0);
+
+  // the worker got a thread id of its own
+  const auto mainThread = trace.substr(trace.find("\"tid\":", trace.find("outer zone")), 8);
+  const auto workerThread = trace.substr(trace.find("\"tid\":", trace.find("worker zone")), 8);
+  REQUIRE(mainThread != workerThread);
+
+  tracing::start();
+  REQUIRE(occurrences(chromeTrace(), "outer zone") == 0);
+  tracing::stop();
+}
+
+TEST_CASE("Tracing keeps the latest events of each thread")
+{
+  tracing::start();
+  for(auto i = std::size_t{0}; i < tracing::eventsPerThread; ++i) tracing::counter("old", 1.0);
+  tracing::counter("new", 2.0);
+  tracing::stop();
+
+  const auto trace = chromeTrace();
+  REQUIRE(occurrences(trace, "\"name\":\"old\"") == tracing::eventsPerThread - 1);
+  REQUIRE(occurrences(trace, "\"name\":\"new\"") == 1);
+  // oldest first, so the newest event closes the list
+  REQUIRE(trace.rfind("\"name\":\"new\"") > trace.rfind("\"name\":\"old\""));
+}
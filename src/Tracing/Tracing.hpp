@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Scoped zones and counters for a Chrome trace, to be opened in chrome://tracing or ui.perfetto.dev. Each thread
+// records into its own ring buffer, so threads never wait for each other. The TRACE_ macros compile to nothing unless
+// the build enables tracing (cmake -DENABLE_TRACING=ON), and record nothing until start().
+namespace tracing
+{
+#ifdef ENABLE_TRACING
+  constexpr auto compiledIn = true;
+#else
+  constexpr auto compiledIn = false;
+#endif
+
+  // events kept per thread; older ones are overwritten
+  constexpr std::size_t eventsPerThread = std::size_t{1} << 16;
+
+  // discards what was recorded so far
+  void start();
+  void stop();
+  bool recording();
+
+  // shown for the calling thread in the trace
+  void nameThread(const char* name);
+
+  // Nanoseconds on a monotonic clock. Names are kept as pointers, so they have to outlive the trace.
+  std::int64_t now();
+  void complete(const char* category, const char* name, std::int64_t begin, std::int64_t end);
+  void counter(const char* name, double value);
+
+  // all threads, each oldest event first
+  void writeChromeTrace(std::ostream& out);
+  bool writeChromeTrace(const std::string& path);
+
+  // records its lifetime as one event
+  class Zone
+  {
+  public:
+    Zone(const char* category, const char* name) : category_(category), name_(name), begin_(recording() ? now() : -1)
+    {
+    }
+
+    ~Zone()
+    {
+      if(begin_ >= 0) complete(category_, name_, begin_, now());
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+  private:
+    const char* category_;
+    const char* name_;
+    std::int64_t begin_;
+  };
+} // namespace tracing
+
+#ifdef ENABLE_TRACING
+#define TRACING_CONCAT_IMPL(a, b) a##b
+#define TRACING_CONCAT(a, b) TRACING_CONCAT_IMPL(a, b)
+// zone from here to the end of the enclosing scope
+#define TRACE_ZONE(category, name) const ::tracing::Zone TRACING_CONCAT(traceZone, __LINE__)(category, name)
+// does not evaluate value when tracing is compiled out
+#define TRACE_COUNTER(name, value) ::tracing::counter(name, static_cast<double>(value))
+#else
+#define TRACE_ZONE(category, name) static_cast<void>(0)
+#define TRACE_COUNTER(name, value) static_cast<void>(0)
+#endif
@@ -1 +1,24 @@
-#include "IModel.hpp"
\ No newline at end of file
+#include "IModel.hpp"
+
+namespace ui
+{
+  void ModelEntity::moveTo(const QVector3D& newPosition)
+  {
+    model_->moveTo(handle_, newPosition);
+  }
+
+  void ModelEntity::rotate()
+  {
+    model_->rotate(handle_);
+  }
+
+  QVector3D ModelEntity::position() const
+  {
+    return model_->position(handle_);
+  }
+
+  float ModelEntity::yRotation() const
+  {
+    return model_->yRotation(handle_);
+  }
+} // namespace ui
@@ -1,34 +1,126 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <QObject>
 
 #include <QVector3D>
 
 namespace ui
 {
-  class IModelEntity : public QObject
+  using EntityHandle = std::uint32_t;
+
+  class IModel;
+
+  enum class ChangeKind
   {
-    Q_OBJECT;
+    Inserted,
+    Updated, // moved, rotated, or replaced by a new brick under the same handle
+    Removed,
+  };
+
+  struct EntityChange
+  {
+    EntityHandle handle{};
+    ChangeKind kind{};
+
+    bool operator==(const EntityChange& other) const
+    {
+      return handle == other.handle && kind == other.kind;
+    }
+  };
+
+  using ChunkId = std::uint64_t;
+
+  // Region of the scene for visibility tests. The box encloses every brick of the chunk.
+  struct ChunkBounds
+  {
+    ChunkId id{};
+    QVector3D min;
+    QVector3D max;
+    std::size_t entityCount{};
+  };
+
+  struct PickResult
+  {
+    EntityHandle handle{};
+    QVector3D position; // where the ray enters the brick
+  };
 
+  // Refers to one brick of a model. Holds no state of its own, so it is cheap to create on demand and to copy.
+  class ModelEntity
+  {
   public:
-    virtual void moveTo(const QVector3D& newPosition) = 0;
-    virtual void rotate() = 0;
+    void moveTo(const QVector3D& newPosition);
+    void rotate();
 
-    virtual QVector3D position() const = 0;
-    virtual float yRotation() const = 0;
+    QVector3D position() const;
+    float yRotation() const;
 
-  signals:
-    void dataChanged();
+    EntityHandle handle() const
+    {
+      return handle_;
+    }
 
-    // boilerplate
+    // Ctor
   public:
-    virtual ~IModelEntity() = default;
+    ModelEntity(IModel& model, EntityHandle handle) : model_(&model), handle_(handle) {}
+
+  private:
+    IModel* model_;
+    EntityHandle handle_;
   };
 
-  class IModel
+  class IModel : public QObject
   {
+    Q_OBJECT;
+
   public:
-    virtual std::shared_ptr<IModelEntity> get() const = 0;
+    virtual std::vector<EntityHandle> entities() const = 0;
+
+    ModelEntity entity(EntityHandle handle)
+    {
+      return ModelEntity(*this, handle);
+    }
+
+    virtual void moveTo(EntityHandle handle, const QVector3D& newPosition) = 0;
+    virtual void rotate(EntityHandle handle) = 0;
+
+    virtual QVector3D position(EntityHandle handle) const = 0;
+    virtual float yRotation(EntityHandle handle) const = 0;
+    // the same rotation as a count of quarter turns, 0 to 3
+    virtual int quarterTurns(EntityHandle handle) const = 0;
+
+    // nearest brick hit by the ray, in world coordinates
+    virtual std::optional<PickResult> pick(const QVector3D& origin, const QVector3D& direction) const = 0;
+
+    // Every brick lies in exactly one chunk; only chunks holding bricks are listed. A brick may change chunk when it
+    // moves.
+    virtual std::vector<ChunkBounds> chunks() const = 0;
+    virtual std::vector<EntityHandle> entitiesIn(ChunkId chunk) const = 0;
+    virtual ChunkId chunkOf(EntityHandle handle) const = 0;
+
+    // empty if the brick would overlap another one
+    virtual std::optional<EntityHandle> add(const QVector3D& position, float yRotation) = 0;
+    virtual void remove(EntityHandle handle) = 0;
+
+    // Applied in one pass. If any brick would end up overlapping another one, nothing moves.
+    virtual void moveMany(const std::vector<EntityHandle>& handles, const std::vector<QVector3D>& newPositions) = 0;
+    virtual void rotateMany(const std::vector<EntityHandle>& handles) = 0;
+
+    // Mutations only record which bricks changed. This emits one entitiesChanged listing each of them once with its
+    // combined change, or nothing if there were no changes; the UI calls it once per frame. Only entitiesChanged says
+    // what changed, there are no per-brick signals. A removed handle may come back as Inserted later.
+    virtual void flushChanges() = 0;
+
+  signals:
+    void entitiesChanged(const std::vector<ui::EntityChange>& changes);
+    // sent by the first mutation after a flush, so whoever flushes learns there is something to flush
+    void changesPending();
 
     // boilerplate
   public:
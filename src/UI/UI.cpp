@@ -1,20 +1,84 @@
 #include "UI.hpp"
 
+#include <QCommandLineParser>
 #include <QGuiApplication>
 #include <QtWidgets/QApplication>
 
+#include <Qt3DExtras/qt3dwindow.h>
+
+#include "Tracing/Tracing.hpp"
+#include "detail/LatencyDump.hpp"
 #include "detail/SceneWidget.hpp"
+#include "detail/TracingAspect.hpp"
 #include "detail/initializeContent.hpp"
 
+namespace
+{
+  // one zone per event the loop delivers, nested when handling an event sends another
+  class TracedApplication : public QApplication
+  {
+  public:
+    using QApplication::QApplication;
+
+    bool notify(QObject* receiver, QEvent* event) override
+    {
+      TRACE_ZONE("ui", "event");
+      return QApplication::notify(receiver, event);
+    }
+  };
+
+  void traceUntilQuit(QApplication& app, SceneWidget& scene, const QString& path)
+  {
+    tracing::nameThread("main");
+    scene.view()->registerAspect(new TracingAspect());
+    tracing::start();
+
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [path] {
+      tracing::stop();
+      tracing::writeChromeTrace(path.toStdString());
+    });
+  }
+} // namespace
+
 namespace ui
 {
   int runUI(int argc, char** argv, std::shared_ptr<IModel> model)
   {
-    QApplication app(argc, argv);
+    TracedApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const auto instanced =
+      QCommandLineOption(QStringLiteral("instanced"), QStringLiteral("Draw all bricks with one instanced draw call."));
+    parser.addOption(instanced);
+    const auto latencyDump = QCommandLineOption(QStringLiteral("latency-dump"),
+                                                QStringLiteral("Write drag latencies as JSON to <path> on exit."),
+                                                QStringLiteral("path"));
+    parser.addOption(latencyDump);
+    const auto trace = QCommandLineOption(QStringLiteral("trace"),
+                                          QStringLiteral("Write a Chrome trace to <path> on exit."),
+                                          QStringLiteral("path"));
+    if constexpr(tracing::compiledIn) parser.addOption(trace);
+    parser.process(app);
 
     auto* sceneWidget = new SceneWidget();
+    if constexpr(tracing::compiledIn)
+    {
+      if(parser.isSet(trace)) traceUntilQuit(app, *sceneWidget, parser.value(trace));
+    }
+
+    const auto latency = std::make_shared<LatencyTracker>();
+    initializeContent(*sceneWidget,
+                      model,
+                      parser.isSet(instanced) ? BrickRendering::Instanced : BrickRendering::EntityPerBrick,
+                      latency);
 
-    initializeContent(sceneWidget->rootEntity(), model);
+    if(parser.isSet(latencyDump))
+    {
+      QObject::connect(&app, &QCoreApplication::aboutToQuit, [latency, path = parser.value(latencyDump)] {
+        writeLatencyDump(path, *latency);
+      });
+    }
 
     // Show window
     sceneWidget->show();
@@ -0,0 +1,23 @@
+#include "BrickInstance.hpp"
+
+#include <cmath>
+
+BrickInstance makeBrickInstance(const QVector3D& position, float yRotationDegrees)
+{
+  constexpr auto radiansPerDegree = 3.14159265358979f / 180.0f;
+  return {position.x(), position.y(), position.z(), yRotationDegrees * radiansPerDegree, 1.0f};
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("BrickInstance")
+{
+  const auto instance = makeBrickInstance({1.5f, 0.36f, -3.0f}, 90.0f);
+  REQUIRE(instance.x == 1.5f);
+  REQUIRE(instance.y == 0.36f);
+  REQUIRE(instance.z == -3.0f);
+  REQUIRE(std::abs(instance.yRotation - 1.5707963f) < 1e-6f);
+  REQUIRE(instance.scale == 1.0f);
+
+  REQUIRE(BrickInstance().scale == 0.0f);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QVector3D>
+
+// Per-instance vertex data of one brick, laid out as the instanced brick shader reads it.
+struct BrickInstance
+{
+  float x{};
+  float y{};
+  float z{};
+  float yRotation{}; // radians
+  float scale{};     // 0 for slots without a brick, which collapses the instance to a point
+};
+static_assert(sizeof(BrickInstance) == 5 * sizeof(float));
+
+BrickInstance makeBrickInstance(const QVector3D& position, float yRotationDegrees);
@@ -0,0 +1,103 @@
+#include "BrickResources.hpp"
+
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QTechnique>
+
+namespace
+{
+  // Top faces are drawn brighter than the sides, so that unlit bricks do not melt into one silhouette.
+  constexpr auto unlitVertexShader = R"(#version 150 core
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+
+out float shade;
+
+uniform mat4 mvp;
+
+void main()
+{
+  shade = 0.75 + 0.25 * abs(vertexNormal.y);
+  gl_Position = mvp * vec4(vertexPosition, 1.0);
+}
+)";
+
+  constexpr auto unlitFragmentShader = R"(#version 150 core
+in float shade;
+
+out vec4 fragColor;
+
+uniform vec4 color;
+
+void main()
+{
+  fragColor = vec4(color.rgb * shade, 1.0);
+}
+)";
+
+  auto makeUnlitEffect()
+  {
+    auto* shader = new Qt3DRender::QShaderProgram();
+    shader->setVertexShaderCode(unlitVertexShader);
+    shader->setFragmentShaderCode(unlitFragmentShader);
+
+    auto* pass = new Qt3DRender::QRenderPass();
+    pass->setShaderProgram(shader);
+
+    auto* technique = new Qt3DRender::QTechnique();
+    technique->graphicsApiFilter()->setApi(Qt3DRender::QGraphicsApiFilter::OpenGL);
+    technique->graphicsApiFilter()->setProfile(Qt3DRender::QGraphicsApiFilter::CoreProfile);
+    technique->graphicsApiFilter()->setMajorVersion(3);
+    technique->graphicsApiFilter()->setMinorVersion(2);
+    technique->addRenderPass(pass);
+
+    auto* filterKey = new Qt3DRender::QFilterKey();
+    filterKey->setName(QStringLiteral("renderingStyle"));
+    filterKey->setValue(QStringLiteral("forward"));
+    technique->addFilterKey(filterKey);
+
+    auto* effect = new Qt3DRender::QEffect();
+    effect->addTechnique(technique);
+    return effect;
+  }
+} // namespace
+
+Qt3DExtras::QCuboidMesh* BrickResources::mesh(const QVector3D& extents)
+{
+  auto& mesh = meshes_[std::tuple(extents.x(), extents.y(), extents.z())];
+  if(!mesh)
+  {
+    mesh = new Qt3DExtras::QCuboidMesh(owner_);
+    mesh->setXExtent(extents.x());
+    mesh->setYExtent(extents.y());
+    mesh->setZExtent(extents.z());
+  }
+  return mesh;
+}
+
+Qt3DExtras::QPhongMaterial* BrickResources::material(const QColor& diffuse)
+{
+  auto& material = materials_[diffuse.rgba()];
+  if(!material)
+  {
+    material = new Qt3DExtras::QPhongMaterial(owner_);
+    material->setDiffuse(diffuse);
+  }
+  return material;
+}
+
+Qt3DRender::QMaterial* BrickResources::unlitMaterial(const QColor& color)
+{
+  auto& material = unlitMaterials_[color.rgba()];
+  if(!material)
+  {
+    material = new Qt3DRender::QMaterial(owner_);
+    material->setEffect(makeUnlitEffect());
+    material->addParameter(new Qt3DRender::QParameter(QStringLiteral("color"), color));
+  }
+  return material;
+}
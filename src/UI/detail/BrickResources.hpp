@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+
+#include <Qt3DCore/QNode>
+#include <Qt3DExtras/QCuboidMesh>
+#include <Qt3DExtras/QPhongMaterial>
+#include <Qt3DRender/QMaterial>
+
+#include <QColor>
+#include <QVector3D>
+
+// how every brick of the scene is drawn
+struct BrickLook
+{
+  QVector3D extents;
+  QColor color;
+};
+
+// Hands out one mesh per brick size and one material per colour, shared by all bricks that use them. The components
+// are owned by the given node, so they outlive the entities they are added to.
+class BrickResources
+{
+public:
+  Qt3DExtras::QCuboidMesh* mesh(const QVector3D& extents);
+  Qt3DExtras::QPhongMaterial* material(const QColor& diffuse);
+  // flat colour without lighting, for distant bricks
+  Qt3DRender::QMaterial* unlitMaterial(const QColor& color);
+
+  // Ctor
+public:
+  explicit BrickResources(Qt3DCore::QNode* owner) : owner_(owner) {}
+
+private:
+  Qt3DCore::QNode* owner_;
+
+  std::map<std::tuple<float, float, float>, Qt3DExtras::QCuboidMesh*> meshes_;
+  std::map<QRgb, Qt3DExtras::QPhongMaterial*> materials_;
+  std::map<QRgb, Qt3DRender::QMaterial*> unlitMaterials_;
+};
@@ -0,0 +1,42 @@
+#include "BrickRotation.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace
+{
+  // cos and sin of half the angle, as QQuaternion::fromAxisAndAngle computes them
+  constexpr auto halfSqrt2 = 0.70710678f;
+  constexpr auto quarterTurnTable = std::array<QQuaternion, 4>{QQuaternion(1.0f, 0.0f, 0.0f, 0.0f),
+                                                               QQuaternion(halfSqrt2, 0.0f, halfSqrt2, 0.0f),
+                                                               QQuaternion(0.0f, 0.0f, 1.0f, 0.0f),
+                                                               QQuaternion(-halfSqrt2, 0.0f, halfSqrt2, 0.0f)};
+} // namespace
+
+QQuaternion brickRotation(int quarterTurns)
+{
+  assert(quarterTurns >= 0 && quarterTurns < 4);
+  return quarterTurnTable[static_cast<std::size_t>(quarterTurns)];
+}
+
+#include <doctest/doctest.hpp>
+
+namespace
+{
+  bool nearlyEqual(const QVector3D& lhs, const QVector3D& rhs)
+  {
+    return (lhs - rhs).length() < 1e-6f;
+  }
+} // namespace
+
+TEST_CASE("Brick rotations turn about y by quarters")
+{
+  REQUIRE(nearlyEqual(brickRotation(0).rotatedVector({1.0f, 0.0f, 0.0f}), {1.0f, 0.0f, 0.0f}));
+
+  // a quarter turn about y takes x to -z and z to x
+  REQUIRE(nearlyEqual(brickRotation(1).rotatedVector({1.0f, 0.0f, 0.0f}), {0.0f, 0.0f, -1.0f}));
+  REQUIRE(nearlyEqual(brickRotation(1).rotatedVector({0.0f, 0.0f, 1.0f}), {1.0f, 0.0f, 0.0f}));
+  REQUIRE(nearlyEqual(brickRotation(2).rotatedVector({1.0f, 1.0f, 0.0f}), {-1.0f, 1.0f, 0.0f}));
+  REQUIRE(nearlyEqual(brickRotation(3).rotatedVector({1.0f, 0.0f, 0.0f}), {0.0f, 0.0f, 1.0f}));
+}
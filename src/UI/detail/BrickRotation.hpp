@@ -0,0 +1,7 @@
+#pragma once
+
+#include <QQuaternion>
+
+// Turn of a brick about y by quarterTurns times 90 degrees, as QTransform::setRotationY would set it. Comes from a
+// table, so setting a brick's rotation takes no trigonometry.
+QQuaternion brickRotation(int quarterTurns);
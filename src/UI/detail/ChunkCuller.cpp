@@ -0,0 +1,168 @@
+#include "ChunkCuller.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <QElapsedTimer>
+
+#include "Frustum.hpp"
+
+ChunkCuller::ChunkCuller(Qt3DCore::QEntity* rootEntity,
+                         std::shared_ptr<ui::IModel> model,
+                         std::shared_ptr<std::vector<Qt3DCore::QEntity*>> entities,
+                         std::shared_ptr<BrickResources> resources,
+                         BrickLook look) :
+  rootEntity_(rootEntity),
+  model_(std::move(model)),
+  entities_(std::move(entities)),
+  resources_(std::move(resources)),
+  look_(std::move(look)),
+  chunkOf_(entities_->size()),
+  unlit_(entities_->size(), false)
+{
+  for(auto handle = ui::EntityHandle{0}; handle < entities_->size(); ++handle)
+  {
+    if((*entities_)[handle]) chunkOf_[handle] = model_->chunkOf(handle);
+  }
+}
+
+CullingStats ChunkCuller::cull(const QMatrix4x4& viewProjection, const QVector3D& cameraPosition)
+{
+  auto timer = QElapsedTimer();
+  timer.start();
+
+  const auto frustum = Frustum(viewProjection.constData());
+  auto stats = CullingStats();
+
+  for(const auto& bounds : model_->chunks())
+  {
+    auto& chunk = chunks_[bounds.id];
+    const auto visible = frustum.intersects(bounds.min, bounds.max);
+    const auto tier = lodTierFor(chunk.tier, distanceToBox(cameraPosition, bounds.min, bounds.max), thresholds_);
+
+    ++stats.chunks;
+    stats.bricks += bounds.entityCount;
+    if(visible)
+    {
+      ++stats.visibleChunks;
+      stats.visibleBricks += bounds.entityCount;
+      stats.unlitChunks += tier == LodTier::Unlit ? 1 : 0;
+      stats.impostorChunks += tier == LodTier::Impostor ? 1 : 0;
+    }
+
+    if(visible == chunk.visible && tier == chunk.tier) continue;
+
+    chunk.visible = visible;
+    chunk.tier = tier;
+
+    for(const auto handle : model_->entitiesIn(bounds.id)) present(handle, chunk);
+    refreshImpostor(bounds.id, chunk);
+  }
+
+  stats.milliseconds = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+  return stats;
+}
+
+void ChunkCuller::update(const std::vector<ui::EntityChange>& changes)
+{
+  if(chunkOf_.size() < entities_->size())
+  {
+    chunkOf_.resize(entities_->size());
+    unlit_.resize(entities_->size(), false);
+  }
+
+  auto touched = std::unordered_set<ui::ChunkId>();
+  for(const auto& change : changes)
+  {
+    const auto handle = change.handle;
+
+    // the entity is gone, but the impostor of its last chunk still encloses it
+    if(change.kind == ui::ChangeKind::Removed)
+    {
+      touched.insert(chunkOf_[handle]);
+      continue;
+    }
+
+    // new entities start out lit and enabled
+    if(change.kind == ui::ChangeKind::Inserted)
+      unlit_[handle] = false;
+    else
+      touched.insert(chunkOf_[handle]);
+
+    chunkOf_[handle] = model_->chunkOf(handle);
+    touched.insert(chunkOf_[handle]);
+
+    present(handle, chunks_[chunkOf_[handle]]);
+  }
+
+  for(const auto id : touched) refreshImpostor(id, chunks_[id]);
+}
+
+void ChunkCuller::present(ui::EntityHandle handle, const ChunkState& chunk)
+{
+  auto* entity = (*entities_)[handle];
+
+  const auto enabled = chunk.visible && chunk.tier != LodTier::Impostor;
+  entity->setEnabled(enabled);
+  if(!enabled) return;
+
+  const auto unlit = chunk.tier == LodTier::Unlit;
+  if(unlit == unlit_[handle]) return;
+
+  if(unlit)
+  {
+    entity->removeComponent(resources_->material(look_.color));
+    entity->addComponent(resources_->unlitMaterial(look_.color));
+  }
+  else
+  {
+    entity->removeComponent(resources_->unlitMaterial(look_.color));
+    entity->addComponent(resources_->material(look_.color));
+  }
+  unlit_[handle] = unlit;
+}
+
+void ChunkCuller::refreshImpostor(ui::ChunkId id, ChunkState& chunk)
+{
+  const auto handles = model_->entitiesIn(id);
+  const auto shown = chunk.visible && chunk.tier == LodTier::Impostor && !handles.empty();
+  if(!shown)
+  {
+    if(chunk.impostor) chunk.impostor->setEnabled(false);
+    return;
+  }
+
+  // box around the bricks of the chunk; bricks turned by a quarter swap their x and z extents
+  constexpr auto infinity = std::numeric_limits<float>::infinity();
+  auto min = QVector3D(infinity, infinity, infinity);
+  auto max = -min;
+  for(const auto handle : handles)
+  {
+    const auto position = model_->position(handle);
+    const auto turned = model_->quarterTurns(handle) % 2 != 0;
+    const auto half = 0.5f * QVector3D(turned ? look_.extents.z() : look_.extents.x(),
+                                       look_.extents.y(),
+                                       turned ? look_.extents.x() : look_.extents.z());
+    for(auto axis = 0; axis < 3; ++axis)
+    {
+      min[axis] = std::min(min[axis], position[axis] - half[axis]);
+      max[axis] = std::max(max[axis], position[axis] + half[axis]);
+    }
+  }
+
+  if(!chunk.impostor)
+  {
+    chunk.impostor = new Qt3DCore::QEntity(rootEntity_);
+    chunk.impostorMesh = new Qt3DExtras::QCuboidMesh(chunk.impostor);
+    chunk.impostorTransform = new Qt3DCore::QTransform(chunk.impostor);
+    chunk.impostor->addComponent(chunk.impostorMesh);
+    chunk.impostor->addComponent(chunk.impostorTransform);
+    chunk.impostor->addComponent(resources_->unlitMaterial(look_.color));
+  }
+
+  chunk.impostorMesh->setXExtent(max.x() - min.x());
+  chunk.impostorMesh->setYExtent(max.y() - min.y());
+  chunk.impostorMesh->setZExtent(max.z() - min.z());
+  chunk.impostorTransform->setTranslation(0.5f * (min + max));
+  chunk.impostor->setEnabled(true);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <Qt3DCore/QTransform>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DExtras/QCuboidMesh>
+
+#include <QMatrix4x4>
+#include <QVector3D>
+
+#include "BrickResources.hpp"
+#include "IModel.hpp"
+#include "LevelOfDetail.hpp"
+
+struct CullingStats
+{
+  std::size_t chunks{};
+  std::size_t visibleChunks{};
+  std::size_t bricks{};
+  std::size_t visibleBricks{};
+  std::size_t unlitChunks{};
+  std::size_t impostorChunks{};
+  double milliseconds{};
+};
+
+// Decides per chunk whether and how its bricks are drawn. Chunks outside the camera frustum are disabled. Visible
+// chunks get a level of detail by their distance to the camera: lit bricks, unlit bricks, or a single box enclosing
+// all of the chunk's bricks. Only chunks whose state changes touch their entities. Entities are indexed by handle and
+// shared with the SceneSync that creates them.
+class ChunkCuller
+{
+public:
+  CullingStats cull(const QMatrix4x4& viewProjection, const QVector3D& cameraPosition);
+
+  // Bricks that were added, moved or removed change the impostor of their chunk, and moved bricks may now lie in
+  // another chunk. Expects the entities to be created and deleted already.
+  void update(const std::vector<ui::EntityChange>& changes);
+
+  // Ctor
+public:
+  ChunkCuller(Qt3DCore::QEntity* rootEntity,
+              std::shared_ptr<ui::IModel> model,
+              std::shared_ptr<std::vector<Qt3DCore::QEntity*>> entities,
+              std::shared_ptr<BrickResources> resources,
+              BrickLook look);
+
+private:
+  struct ChunkState
+  {
+    bool visible{true};
+    LodTier tier{LodTier::Full};
+    Qt3DCore::QEntity* impostor{};
+    Qt3DExtras::QCuboidMesh* impostorMesh{};
+    Qt3DCore::QTransform* impostorTransform{};
+  };
+
+  void present(ui::EntityHandle handle, const ChunkState& chunk);
+  void refreshImpostor(ui::ChunkId id, ChunkState& chunk);
+
+  Qt3DCore::QEntity* rootEntity_;
+  std::shared_ptr<ui::IModel> model_;
+  std::shared_ptr<std::vector<Qt3DCore::QEntity*>> entities_;
+  std::shared_ptr<BrickResources> resources_;
+  BrickLook look_;
+  LodThresholds thresholds_;
+
+  // chunks not listed are visible at full detail, as entities start out that way
+  std::unordered_map<ui::ChunkId, ChunkState> chunks_;
+
+  // indexed by handle
+  std::vector<ui::ChunkId> chunkOf_;
+  std::vector<bool> unlit_;
+};
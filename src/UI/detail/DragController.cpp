@@ -0,0 +1,60 @@
+#include "DragController.hpp"
+
+#include <cmath>
+
+void DragController::begin(ui::EntityHandle handle, const QVector3D& grabPoint, const QVector3D& brickPosition)
+{
+  handle_ = handle;
+  planeHeight_ = grabPoint.y();
+  grabOffset_ = brickPosition - grabPoint;
+}
+
+void DragController::end()
+{
+  handle_.reset();
+}
+
+std::optional<ui::EntityHandle> DragController::dragged() const
+{
+  return handle_;
+}
+
+std::optional<QVector3D> DragController::follow(const QVector3D& origin, const QVector3D& direction) const
+{
+  if(!handle_) return std::nullopt;
+
+  // rays running (almost) parallel to the plane would throw the brick towards the horizon
+  constexpr auto minimumSlope = 1e-4f;
+  if(std::abs(direction.y()) < minimumSlope * direction.length()) return std::nullopt;
+
+  const auto distance = (planeHeight_ - origin.y()) / direction.y();
+  if(distance < 0.0f) return std::nullopt;
+
+  return origin + distance * direction + grabOffset_;
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("DragController")
+{
+  auto drag = DragController();
+  REQUIRE(!drag.follow({0.0f, 10.0f, 0.0f}, {0.0f, -1.0f, 0.0f}));
+
+  drag.begin(3, {1.0f, 0.72f, 0.25f}, {0.5f, 0.36f, 0.0f});
+  REQUIRE(drag.dragged() == 3u);
+
+  // the brick keeps its offset to the cursor and its own height
+  const auto target = drag.follow({4.0f, 2.72f, 1.0f}, {1.0f, -1.0f, 0.5f});
+  REQUIRE(target);
+  REQUIRE((*target - QVector3D{5.5f, 0.36f, 1.75f}).length() < 1e-5f);
+
+  // far off the brick, where mesh picking would have found nothing
+  REQUIRE(drag.follow({100.0f, 10.72f, -50.0f}, {0.0f, -4.0f, 0.0f}));
+
+  REQUIRE(!drag.follow({0.0f, 2.0f, 0.0f}, {1.0f, 0.0f, 0.0f}));
+  REQUIRE(!drag.follow({0.0f, 2.0f, 0.0f}, {0.0f, 1.0f, 0.0f}));
+
+  drag.end();
+  REQUIRE(!drag.dragged());
+  REQUIRE(!drag.follow({4.0f, 2.72f, 1.0f}, {1.0f, -1.0f, 0.5f}));
+}
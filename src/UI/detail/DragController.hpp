@@ -0,0 +1,26 @@
+#pragma once
+
+#include <optional>
+
+#include <QVector3D>
+
+#include "IModel.hpp"
+
+// Moves a brick along the horizontal plane through the point where it was grabbed. Each cursor ray is intersected
+// with that plane directly, so following the cursor needs no picking, and the brick keeps its offset to the cursor.
+class DragController
+{
+public:
+  void begin(ui::EntityHandle handle, const QVector3D& grabPoint, const QVector3D& brickPosition);
+  void end();
+
+  std::optional<ui::EntityHandle> dragged() const;
+
+  // where the dragged brick should go for the cursor ray; empty without a drag or if the ray misses the plane
+  std::optional<QVector3D> follow(const QVector3D& origin, const QVector3D& direction) const;
+
+private:
+  std::optional<ui::EntityHandle> handle_;
+  float planeHeight_{};
+  QVector3D grabOffset_;
+};
@@ -0,0 +1,45 @@
+#include "FramePacing.hpp"
+
+#include <cstddef>
+
+void DutyCycle::enter(FramePhase phase, double now)
+{
+  seconds_[static_cast<std::size_t>(phase_)] += now - since_;
+  phase_ = phase;
+  since_ = now;
+}
+
+FramePhase DutyCycle::phase() const
+{
+  return phase_;
+}
+
+double DutyCycle::share(FramePhase phase, double now) const
+{
+  const auto total = now - start_;
+  if(total <= 0.0) return phase == phase_ ? 1.0 : 0.0;
+
+  auto seconds = seconds_[static_cast<std::size_t>(phase)];
+  if(phase == phase_) seconds += now - since_;
+  return seconds / total;
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("DutyCycle")
+{
+  auto duty = DutyCycle(10.0);
+  REQUIRE(duty.phase() == FramePhase::Active);
+  REQUIRE(duty.share(FramePhase::Active, 10.0) == 1.0);
+  REQUIRE(duty.share(FramePhase::Idle, 10.0) == 0.0);
+
+  duty.enter(FramePhase::Dragging, 11.0);
+  duty.enter(FramePhase::Active, 12.0);
+  duty.enter(FramePhase::Idle, 12.0);
+  REQUIRE(duty.phase() == FramePhase::Idle);
+
+  // the phase entered last counts up to now
+  REQUIRE(duty.share(FramePhase::Active, 20.0) == doctest::Approx(0.1));
+  REQUIRE(duty.share(FramePhase::Dragging, 20.0) == doctest::Approx(0.1));
+  REQUIRE(duty.share(FramePhase::Idle, 20.0) == doctest::Approx(0.8));
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+enum class FramePhase : std::uint8_t
+{
+  Idle,     // nothing changes, frames are only rendered on demand
+  Active,   // rendering every frame
+  Dragging, // flushing model changes and rendering at most once per capped frame interval
+};
+
+struct FramePacing
+{
+  int idleAfterMilliseconds{500};
+  int dragFramesPerSecond{30};
+};
+
+// Share of the time spent in each phase. Times are in seconds on any monotonic clock.
+class DutyCycle
+{
+public:
+  void enter(FramePhase phase, double now);
+
+  FramePhase phase() const;
+  // 0 to 1; the shares of all phases add up to 1 once any time has passed
+  double share(FramePhase phase, double now) const;
+
+  // Ctor
+public:
+  explicit DutyCycle(double now = 0.0) : start_(now), since_(now) {}
+
+private:
+  FramePhase phase_{FramePhase::Active};
+  double start_;
+  double since_;
+  std::array<double, 3> seconds_{};
+};
@@ -0,0 +1,130 @@
+#include "FrameScheduler.hpp"
+
+#include <Qt3DLogic/QFrameAction>
+
+#include <Qt3DRender/QCamera>
+
+#include <QEvent>
+#include <QMouseEvent>
+
+FrameScheduler::FrameScheduler(Qt3DCore::QEntity* rootEntity,
+                               std::shared_ptr<ui::IModel> model,
+                               Qt3DExtras::Qt3DWindow* view,
+                               FramePacing pacing) :
+  QObject(rootEntity),
+  model_(std::move(model)),
+  renderSettings_(view->renderSettings())
+{
+  clock_.start();
+
+  idleTimer_.setSingleShot(true);
+  idleTimer_.setInterval(pacing.idleAfterMilliseconds);
+  connect(&idleTimer_, &QTimer::timeout, this, [this] { enter(FramePhase::Idle); });
+
+  // the timer drives the flushes while dragging, so a burst of mouse moves is written at most once per capped frame
+  dragTimer_.setInterval(1000 / pacing.dragFramesPerSecond);
+  connect(&dragTimer_, &QTimer::timeout, this, [this] { model_->flushChanges(); });
+
+  // A drag step that changed the scene asks for exactly one frame, so rendering is capped along with the flushes.
+  connect(model_.get(), &ui::IModel::entitiesChanged, this, [this] {
+    if(dutyCycle_.phase() == FramePhase::Dragging) requestFrame();
+  });
+
+  // Several mouse events may arrive per rendered frame; flushing once per frame writes each transform at most once.
+  auto* frameAction = new Qt3DLogic::QFrameAction();
+  connect(frameAction, &Qt3DLogic::QFrameAction::triggered, this, [this](float /*dt*/) {
+    if(dutyCycle_.phase() == FramePhase::Active) model_->flushChanges();
+
+    // this frame synced the requested step, so the window goes back to rendering on demand
+    if(frameRequested_)
+    {
+      frameRequested_ = false;
+      renderSettings_->setRenderPolicy(Qt3DRender::QRenderSettings::OnDemand);
+    }
+  });
+  rootEntity->addComponent(frameAction);
+
+  // Flushes only happen while frames are rendered, so an idle scene learns of changes from the mutation itself.
+  connect(model_.get(), &ui::IModel::changesPending, this, [this] { wake(); });
+  connect(view->camera(), &Qt3DRender::QCamera::viewMatrixChanged, this, [this] { wake(); });
+  view->installEventFilter(this);
+
+  dutyCycle_ = DutyCycle(now());
+  enter(FramePhase::Active);
+}
+
+FramePhase FrameScheduler::phase() const
+{
+  return dutyCycle_.phase();
+}
+
+double FrameScheduler::share(FramePhase phase) const
+{
+  return dutyCycle_.share(phase, now());
+}
+
+bool FrameScheduler::eventFilter(QObject* watched, QEvent* event)
+{
+  switch(event->type())
+  {
+  case QEvent::MouseButtonPress:
+    if(static_cast<QMouseEvent*>(event)->button() == Qt::LeftButton) enter(FramePhase::Dragging);
+    break;
+  case QEvent::MouseButtonRelease:
+    if(static_cast<QMouseEvent*>(event)->button() == Qt::LeftButton)
+    {
+      enter(FramePhase::Active);
+      // the last drag step lands without waiting for the next capped frame
+      model_->flushChanges();
+    }
+    break;
+  case QEvent::MouseMove:
+  case QEvent::Wheel:
+  case QEvent::KeyPress:
+  case QEvent::Resize:
+  case QEvent::Expose: wake(); break;
+  default: break;
+  }
+
+  return QObject::eventFilter(watched, event);
+}
+
+double FrameScheduler::now() const
+{
+  return static_cast<double>(clock_.nsecsElapsed()) / 1e9;
+}
+
+void FrameScheduler::wake()
+{
+  if(dutyCycle_.phase() == FramePhase::Dragging) return;
+
+  if(dutyCycle_.phase() != FramePhase::Active) enter(FramePhase::Active);
+  idleTimer_.start();
+}
+
+void FrameScheduler::requestFrame()
+{
+  // On demand alone would render the changed transforms, but not reliably run the frame actions that flush and
+  // stamp the latency. Rendering continuously until the next frame action covers both.
+  frameRequested_ = true;
+  renderSettings_->setRenderPolicy(Qt3DRender::QRenderSettings::Always);
+}
+
+void FrameScheduler::enter(FramePhase phase)
+{
+  dutyCycle_.enter(phase, now());
+
+  frameRequested_ = false;
+  renderSettings_->setRenderPolicy(phase == FramePhase::Active ? Qt3DRender::QRenderSettings::Always
+                                                               : Qt3DRender::QRenderSettings::OnDemand);
+
+  if(phase == FramePhase::Dragging)
+    dragTimer_.start();
+  else
+    dragTimer_.stop();
+
+  if(phase == FramePhase::Active)
+    idleTimer_.start();
+  else
+    idleTimer_.stop();
+}
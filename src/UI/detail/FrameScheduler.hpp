@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+
+#include <Qt3DCore/qentity.h>
+#include <Qt3DExtras/qt3dwindow.h>
+#include <Qt3DRender/QRenderSettings>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+#include "FramePacing.hpp"
+#include "IModel.hpp"
+
+// Decides when the scene is rendered and when model changes are flushed into it. While nothing happens the window
+// renders on demand only, so an idle scene costs no CPU or GPU time. Input to the window, camera moves and model
+// changes make it render every frame again until it has been idle for a while. While a mouse button is held,
+// changes are flushed at a capped rate instead, and each flush that changed the scene renders one frame, so a drag
+// renders no faster than the cap and not at all while the mouse holds still. Owned by the entity it is created for.
+class FrameScheduler : public QObject
+{
+public:
+  FramePhase phase() const;
+  // share of the time since startup spent in phase
+  double share(FramePhase phase) const;
+
+  // Ctor
+public:
+  FrameScheduler(Qt3DCore::QEntity* rootEntity,
+                 std::shared_ptr<ui::IModel> model,
+                 Qt3DExtras::Qt3DWindow* view,
+                 FramePacing pacing = {});
+
+protected:
+  bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+  double now() const;
+  void wake();
+  // renders frames until the next frame action, then returns to rendering on demand
+  void requestFrame();
+  void enter(FramePhase phase);
+
+  std::shared_ptr<ui::IModel> model_;
+  Qt3DRender::QRenderSettings* renderSettings_;
+
+  QTimer idleTimer_;
+  QTimer dragTimer_;
+  QElapsedTimer clock_;
+  DutyCycle dutyCycle_;
+  bool frameRequested_{};
+};
@@ -0,0 +1,65 @@
+#include "Frustum.hpp"
+
+#include <cstddef>
+
+Frustum::Frustum(const float* viewProjection)
+{
+  const auto element = [viewProjection](std::size_t row, std::size_t column) {
+    return viewProjection[column * 4 + row];
+  };
+
+  // Gribb/Hartmann: each plane is the last row of the matrix plus or minus one of the others
+  for(auto i = std::size_t{0}; i < 6; ++i)
+  {
+    const auto row = i / 2;
+    const auto sign = i % 2 == 0 ? 1.0f : -1.0f;
+    for(auto column = std::size_t{0}; column < 4; ++column)
+    {
+      planes_[i][column] = element(3, column) + sign * element(row, column);
+    }
+  }
+}
+
+bool Frustum::intersects(const QVector3D& min, const QVector3D& max) const
+{
+  for(const auto& plane : planes_)
+  {
+    // the corner furthest along the plane normal
+    const auto x = plane[0] >= 0.0f ? max.x() : min.x();
+    const auto y = plane[1] >= 0.0f ? max.y() : min.y();
+    const auto z = plane[2] >= 0.0f ? max.z() : min.z();
+    if(plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) return false;
+  }
+  return true;
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Frustum")
+{
+  SUBCASE("Identity clips to the unit cube")
+  {
+    const auto identity = std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    const auto frustum = Frustum(identity.data());
+
+    REQUIRE(frustum.intersects({-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}));
+    REQUIRE(frustum.intersects({0.9f, 0.9f, 0.9f}, {5.0f, 5.0f, 5.0f}));
+    REQUIRE(frustum.intersects({-5.0f, -5.0f, -5.0f}, {5.0f, 5.0f, 5.0f}));
+    REQUIRE(!frustum.intersects({1.1f, -0.5f, -0.5f}, {2.0f, 0.5f, 0.5f}));
+    REQUIRE(!frustum.intersects({-0.5f, -0.5f, -3.0f}, {0.5f, 0.5f, -1.1f}));
+  }
+
+  SUBCASE("Perspective camera at the origin looking down -z")
+  {
+    // 90 degree field of view, aspect 1, near 1, far 100, column-major
+    const auto perspective =
+      std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, -101.0f / 99.0f, -1, 0, 0, -200.0f / 99.0f, 0};
+    const auto frustum = Frustum(perspective.data());
+
+    REQUIRE(frustum.intersects({-1.0f, -1.0f, -11.0f}, {1.0f, 1.0f, -9.0f}));
+    REQUIRE(frustum.intersects({8.0f, -1.0f, -11.0f}, {12.0f, 1.0f, -9.0f}));
+    REQUIRE(!frustum.intersects({12.0f, -1.0f, -11.0f}, {14.0f, 1.0f, -9.0f}));
+    REQUIRE(!frustum.intersects({-1.0f, -1.0f, 1.0f}, {1.0f, 1.0f, 3.0f}));
+    REQUIRE(!frustum.intersects({-1.0f, -1.0f, -200.0f}, {1.0f, 1.0f, -150.0f}));
+  }
+}
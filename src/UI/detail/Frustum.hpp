@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+
+#include <QVector3D>
+
+// The six clip planes of a view-projection matrix, for conservative box tests.
+class Frustum
+{
+public:
+  // false only if the box lies entirely outside one of the planes
+  bool intersects(const QVector3D& min, const QVector3D& max) const;
+
+  // Ctor
+public:
+  // matrix in column-major order, as QMatrix4x4::constData() returns it, with OpenGL clip space
+  explicit Frustum(const float* viewProjection);
+
+private:
+  // a * x + b * y + c * z + d >= 0 inside
+  std::array<std::array<float, 4>, 6> planes_{};
+};
@@ -0,0 +1,122 @@
+#include "InputDispatcher.hpp"
+
+#include <Qt3DInput/QKeyboardDevice>
+#include <Qt3DInput/QKeyboardHandler>
+#include <Qt3DInput/QMouseDevice>
+#include <Qt3DInput/QMouseHandler>
+
+#include <Qt3DRender/QCamera>
+
+#include <QRect>
+
+#include "Tracing/Tracing.hpp"
+
+InputDispatcher::InputDispatcher(Qt3DCore::QEntity* rootEntity,
+                                 std::shared_ptr<ui::IModel> model,
+                                 Qt3DExtras::Qt3DWindow* view,
+                                 std::shared_ptr<LatencyTracker> latency) :
+  QObject(rootEntity),
+  model_(std::move(model)),
+  view_(view),
+  latency_(std::move(latency))
+{
+  auto* mouseHandler = new Qt3DInput::QMouseHandler();
+  mouseHandler->setSourceDevice(new Qt3DInput::QMouseDevice(rootEntity));
+  connect(mouseHandler, &Qt3DInput::QMouseHandler::pressed, this, [this](Qt3DInput::QMouseEvent* event) {
+    if(event->button() == Qt3DInput::QMouseEvent::LeftButton) press(event->x(), event->y());
+  });
+  connect(mouseHandler, &Qt3DInput::QMouseHandler::positionChanged, this, [this](Qt3DInput::QMouseEvent* event) {
+    selection_.hover(QPoint(event->x(), event->y()));
+    drag(event->x(), event->y());
+  });
+  connect(mouseHandler, &Qt3DInput::QMouseHandler::released, this, [this](Qt3DInput::QMouseEvent* event) {
+    if(event->button() == Qt3DInput::QMouseEvent::LeftButton) release();
+  });
+  connect(mouseHandler, &Qt3DInput::QMouseHandler::wheel, this, [this](Qt3DInput::QWheelEvent* event) {
+    selection_.hover(QPoint(event->x(), event->y()));
+    rotateTarget();
+  });
+  rootEntity->addComponent(mouseHandler);
+
+  auto* keyboardHandler = new Qt3DInput::QKeyboardHandler();
+  keyboardHandler->setSourceDevice(new Qt3DInput::QKeyboardDevice(rootEntity));
+  keyboardHandler->setFocus(true);
+  connect(keyboardHandler, &Qt3DInput::QKeyboardHandler::pressed, this, [this](Qt3DInput::QKeyEvent* event) {
+    if(event->key() == Qt::Key_R) rotateTarget();
+  });
+  rootEntity->addComponent(keyboardHandler);
+}
+
+std::optional<ui::EntityHandle> InputDispatcher::selected() const
+{
+  return selection_.selected();
+}
+
+InputDispatcher::Ray InputDispatcher::rayThrough(int x, int y) const
+{
+  const auto* camera = view_->camera();
+  const auto viewport = QRect(0, 0, view_->width(), view_->height());
+
+  // window coordinates for unproject start at the bottom left, mouse coordinates at the top left
+  const auto windowX = static_cast<float>(x);
+  const auto windowY = static_cast<float>(view_->height() - y);
+  const auto nearPoint =
+    QVector3D(windowX, windowY, 0.0f).unproject(camera->viewMatrix(), camera->projectionMatrix(), viewport);
+  const auto farPoint =
+    QVector3D(windowX, windowY, 1.0f).unproject(camera->viewMatrix(), camera->projectionMatrix(), viewport);
+
+  return {nearPoint, farPoint - nearPoint};
+}
+
+void InputDispatcher::press(int x, int y)
+{
+  TRACE_ZONE("input", "press");
+  const auto ray = rayThrough(x, y);
+  const auto hit = model_->pick(ray.origin, ray.direction);
+  selection_.press(hit ? std::optional(hit->handle) : std::nullopt);
+  if(!hit) return;
+
+  drag_.begin(hit->handle, hit->position, model_->position(hit->handle));
+}
+
+void InputDispatcher::drag(int x, int y)
+{
+  TRACE_ZONE("input", "drag");
+  const auto dragged = drag_.dragged();
+  if(!dragged) return;
+
+  latency_->inputArrived(LatencyTracker::now());
+
+  // most mouse moves stay within a cell and never show on screen
+  auto moved = false;
+  const auto ray = rayThrough(x, y);
+  if(const auto target = drag_.follow(ray.origin, ray.direction))
+  {
+    const auto before = model_->position(*dragged);
+    model_->moveTo(*dragged, *target);
+    moved = model_->position(*dragged) != before;
+  }
+
+  latency_->inputHandled(LatencyTracker::now(), moved);
+}
+
+void InputDispatcher::release()
+{
+  TRACE_ZONE("input", "release");
+  drag_.end();
+}
+
+void InputDispatcher::rotateTarget()
+{
+  TRACE_ZONE("input", "rotate");
+  const auto brick = selection_.target([this](const QPoint& pointer) { return pick(pointer.x(), pointer.y()); });
+  if(brick) model_->rotate(*brick);
+}
+
+std::optional<ui::EntityHandle> InputDispatcher::pick(int x, int y) const
+{
+  const auto ray = rayThrough(x, y);
+  const auto hit = model_->pick(ray.origin, ray.direction);
+  if(!hit) return std::nullopt;
+  return hit->handle;
+}
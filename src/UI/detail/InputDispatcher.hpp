@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <Qt3DCore/qentity.h>
+#include <Qt3DExtras/qt3dwindow.h>
+
+#include <QObject>
+#include <QVector3D>
+
+#include "DragController.hpp"
+#include "IModel.hpp"
+#include "LatencyTracker.hpp"
+#include "Selection.hpp"
+
+// Receives mouse and keyboard input once for the whole scene. Pressing a brick selects it and dragging moves it,
+// pressing empty space deselects; the wheel and the R key rotate the selected brick, or the one under the pointer
+// while none is selected. Presses and
+// rotations cast a camera ray into the model, so there are no per-brick pickers. Drag events are reported to the
+// latency tracker. Owned by the entity it is created for.
+class InputDispatcher : public QObject
+{
+public:
+  std::optional<ui::EntityHandle> selected() const;
+
+  // Ctor
+public:
+  InputDispatcher(Qt3DCore::QEntity* rootEntity,
+                  std::shared_ptr<ui::IModel> model,
+                  Qt3DExtras::Qt3DWindow* view,
+                  std::shared_ptr<LatencyTracker> latency);
+
+private:
+  struct Ray
+  {
+    QVector3D origin;
+    QVector3D direction;
+  };
+
+  Ray rayThrough(int x, int y) const;
+
+  void press(int x, int y);
+  void drag(int x, int y);
+  void release();
+  void rotateTarget();
+  std::optional<ui::EntityHandle> pick(int x, int y) const;
+
+  std::shared_ptr<ui::IModel> model_;
+  Qt3DExtras::Qt3DWindow* view_;
+  std::shared_ptr<LatencyTracker> latency_;
+
+  Selection selection_;
+  DragController drag_;
+};
@@ -0,0 +1,276 @@
+#include "InstancedBricks.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <Qt3DExtras/QCuboidGeometry>
+
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QMaterial>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QTechnique>
+
+#include <QColor>
+
+#include "Tracing/Tracing.hpp"
+
+namespace
+{
+  // Rotates each vertex about y like QTransform::setRotationY, then moves it to the instance position.
+  constexpr auto vertexShader = R"(#version 150 core
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec4 instancePositionAndRotation;
+in float instanceScale;
+
+out vec3 worldNormal;
+
+uniform mat4 viewProjectionMatrix;
+
+vec3 rotateY(vec3 v, float c, float s)
+{
+  return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
+
+void main()
+{
+  float c = cos(instancePositionAndRotation.w);
+  float s = sin(instancePositionAndRotation.w);
+
+  worldNormal = rotateY(vertexNormal, c, s);
+  vec3 worldPosition = rotateY(vertexPosition * instanceScale, c, s) + instancePositionAndRotation.xyz;
+  gl_Position = viewProjectionMatrix * vec4(worldPosition, 1.0);
+}
+)";
+
+  constexpr auto fragmentShader = R"(#version 150 core
+in vec3 worldNormal;
+
+out vec4 fragColor;
+
+uniform vec4 diffuse;
+
+void main()
+{
+  const vec3 lightDirection = normalize(vec3(-0.4, 0.8, 0.8));
+  float lambert = max(dot(normalize(worldNormal), lightDirection), 0.0);
+  fragColor = vec4(diffuse.rgb * (0.3 + 0.7 * lambert), 1.0);
+}
+)";
+
+  const auto brickExtents = QVector3D(2.0f, 0.72f, 1.0f);
+  // bricks only turn by quarters about y, so their longer side may lie along x or z
+  const auto brickReach = QVector3D(0.5f * brickExtents.x(), 0.5f * brickExtents.y(), 0.5f * brickExtents.x());
+
+  // the cuboid indexes its 24 vertices, so the bounds attribute has as many
+  constexpr auto boundsVertexCount = 24u;
+
+  auto makeGeometry()
+  {
+    auto* geometry = new Qt3DExtras::QCuboidGeometry();
+    geometry->setXExtent(brickExtents.x());
+    geometry->setYExtent(brickExtents.y());
+    geometry->setZExtent(brickExtents.z());
+    return geometry;
+  }
+
+  auto makeBoundsAttribute(Qt3DRender::QBuffer* buffer)
+  {
+    auto* attribute = new Qt3DRender::QAttribute(
+      buffer, QStringLiteral("instanceBounds"), Qt3DRender::QAttribute::Float, 3, boundsVertexCount);
+    attribute->setAttributeType(Qt3DRender::QAttribute::VertexAttribute);
+    return attribute;
+  }
+
+  auto makeInstanceAttribute(Qt3DRender::QBuffer* buffer, const QString& name, uint size, std::size_t offset)
+  {
+    auto* attribute = new Qt3DRender::QAttribute(buffer,
+                                                 name,
+                                                 Qt3DRender::QAttribute::Float,
+                                                 size,
+                                                 0,
+                                                 static_cast<uint>(offset),
+                                                 static_cast<uint>(sizeof(BrickInstance)));
+    attribute->setAttributeType(Qt3DRender::QAttribute::VertexAttribute);
+    attribute->setDivisor(1);
+    return attribute;
+  }
+
+  auto makeMaterial()
+  {
+    auto* shader = new Qt3DRender::QShaderProgram();
+    shader->setVertexShaderCode(vertexShader);
+    shader->setFragmentShaderCode(fragmentShader);
+
+    auto* pass = new Qt3DRender::QRenderPass();
+    pass->setShaderProgram(shader);
+
+    // instanced arrays need GL 3.2 core, which software rasterizers like llvmpipe provide as well
+    auto* technique = new Qt3DRender::QTechnique();
+    technique->graphicsApiFilter()->setApi(Qt3DRender::QGraphicsApiFilter::OpenGL);
+    technique->graphicsApiFilter()->setProfile(Qt3DRender::QGraphicsApiFilter::CoreProfile);
+    technique->graphicsApiFilter()->setMajorVersion(3);
+    technique->graphicsApiFilter()->setMinorVersion(2);
+    technique->addRenderPass(pass);
+
+    // matched by the technique filter of the default forward renderer
+    auto* filterKey = new Qt3DRender::QFilterKey();
+    filterKey->setName(QStringLiteral("renderingStyle"));
+    filterKey->setValue(QStringLiteral("forward"));
+    technique->addFilterKey(filterKey);
+
+    auto* effect = new Qt3DRender::QEffect();
+    effect->addTechnique(technique);
+
+    auto* material = new Qt3DRender::QMaterial();
+    material->setEffect(effect);
+    material->addParameter(new Qt3DRender::QParameter(QStringLiteral("diffuse"), QColor(QRgb(0xFFF03A))));
+    return material;
+  }
+
+  QByteArray bytesOf(const BrickInstance* first, std::size_t count)
+  {
+    return QByteArray(reinterpret_cast<const char*>(first), static_cast<int>(count * sizeof(BrickInstance)));
+  }
+} // namespace
+
+InstancedBricks::InstancedBricks(Qt3DCore::QEntity* rootEntity, std::shared_ptr<ui::IModel> model) :
+  model_(std::move(model)),
+  instanceBuffer_(new Qt3DRender::QBuffer()),
+  boundsBuffer_(new Qt3DRender::QBuffer()),
+  renderer_(new Qt3DRender::QGeometryRenderer())
+{
+  instanceBuffer_->setUsage(Qt3DRender::QBuffer::DynamicDraw);
+
+  auto* geometry = makeGeometry();
+  instanceAttributes_ = {
+    makeInstanceAttribute(instanceBuffer_, QStringLiteral("instancePositionAndRotation"), 4, offsetof(BrickInstance, x)),
+    makeInstanceAttribute(instanceBuffer_, QStringLiteral("instanceScale"), 1, offsetof(BrickInstance, scale))};
+  for(auto* attribute : instanceAttributes_) geometry->addAttribute(attribute);
+
+  // The cuboid at the origin does not bound the instances. Qt3D computes the bounding volume by reading this attribute
+  // through the cuboid's indices, so it holds the corners of a box around all instances instead of positions.
+  auto* bounds = makeBoundsAttribute(boundsBuffer_);
+  geometry->addAttribute(bounds);
+  geometry->setBoundingVolumePositionAttribute(bounds);
+
+  renderer_->setGeometry(geometry);
+  renderer_->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
+
+  auto* entity = new Qt3DCore::QEntity(rootEntity);
+  entity->addComponent(renderer_);
+  entity->addComponent(makeMaterial());
+
+  auto initial = std::vector<ui::EntityChange>();
+  for(const auto handle : model_->entities()) initial.push_back({handle, ui::ChangeKind::Inserted});
+  resize(instances_.size());
+  update(initial);
+}
+
+void InstancedBricks::update(const std::vector<ui::EntityChange>& changes)
+{
+  TRACE_ZONE("scene", "instance upload");
+  if(changes.empty()) return;
+
+  const auto highest =
+    std::max_element(changes.begin(), changes.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.handle < rhs.handle;
+    })->handle;
+  if(highest >= instances_.size())
+  {
+    resize(highest + 1);
+    for(const auto& change : changes) load(change);
+    instanceBuffer_->setData(bytesOf(instances_.data(), instances_.size()));
+    uploadBounds();
+    return;
+  }
+
+  // one upload per run of consecutive handles, which is a single one when a whole block of bricks moves
+  auto handles = std::vector<ui::EntityHandle>();
+  handles.reserve(changes.size());
+  for(const auto& change : changes)
+  {
+    load(change);
+    handles.push_back(change.handle);
+  }
+  std::sort(handles.begin(), handles.end());
+
+  for(auto first = handles.begin(); first != handles.end();)
+  {
+    auto last = first + 1;
+    while(last != handles.end() && *last == *(last - 1) + 1) ++last;
+
+    const auto count = static_cast<std::size_t>(last - first);
+    instanceBuffer_->updateData(static_cast<int>(*first * sizeof(BrickInstance)), bytesOf(&instances_[*first], count));
+    first = last;
+  }
+  uploadBounds();
+}
+
+void InstancedBricks::resize(std::size_t instanceCount)
+{
+  instances_.resize(instanceCount);
+  for(auto* attribute : instanceAttributes_) attribute->setCount(static_cast<uint>(instanceCount));
+  renderer_->setInstanceCount(static_cast<int>(instanceCount));
+  // an instance count of 0 would still draw one instance from the empty buffer
+  renderer_->setEnabled(instanceCount > 0);
+}
+
+void InstancedBricks::load(const ui::EntityChange& change)
+{
+  const auto handle = change.handle;
+  if(change.kind == ui::ChangeKind::Removed)
+  {
+    instances_[handle] = BrickInstance();
+    return;
+  }
+
+  const auto position = model_->position(handle);
+  instances_[handle] = makeBrickInstance(position, model_->yRotation(handle));
+
+  const auto min = position - brickReach;
+  const auto max = position + brickReach;
+  if(!bounds_)
+  {
+    bounds_ = Bounds{min, max};
+    boundsGrew_ = true;
+    return;
+  }
+
+  for(auto axis = 0; axis < 3; ++axis)
+  {
+    if(min[axis] < bounds_->min[axis])
+    {
+      bounds_->min[axis] = min[axis];
+      boundsGrew_ = true;
+    }
+    if(max[axis] > bounds_->max[axis])
+    {
+      bounds_->max[axis] = max[axis];
+      boundsGrew_ = true;
+    }
+  }
+}
+
+void InstancedBricks::uploadBounds()
+{
+  if(!boundsGrew_) return;
+  boundsGrew_ = false;
+
+  // the 8 corners, repeated over all vertices the indices may reach
+  auto corners = std::vector<QVector3D>();
+  corners.reserve(boundsVertexCount);
+  for(auto i = 0u; i < boundsVertexCount; ++i)
+  {
+    const auto corner = i % 8;
+    corners.emplace_back(corner & 1 ? bounds_->max.x() : bounds_->min.x(),
+                         corner & 2 ? bounds_->max.y() : bounds_->min.y(),
+                         corner & 4 ? bounds_->max.z() : bounds_->min.z());
+  }
+  boundsBuffer_->setData(
+    QByteArray(reinterpret_cast<const char*>(corners.data()), static_cast<int>(corners.size() * sizeof(QVector3D))));
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <Qt3DCore/qentity.h>
+#include <Qt3DRender/QAttribute>
+#include <Qt3DRender/QBuffer>
+#include <Qt3DRender/QGeometryRenderer>
+
+#include "BrickInstance.hpp"
+#include "IModel.hpp"
+
+// Draws all bricks with one instanced draw call. Instance i is the brick with handle i, and handles without a brick
+// are drawn at scale zero. The per-instance buffer is rewritten only for the handles passed to update(). Nothing is
+// drawn while there are no instances.
+class InstancedBricks
+{
+public:
+  void update(const std::vector<ui::EntityChange>& changes);
+
+  // Ctor
+public:
+  InstancedBricks(Qt3DCore::QEntity* rootEntity, std::shared_ptr<ui::IModel> model);
+
+private:
+  void resize(std::size_t instanceCount);
+  void load(const ui::EntityChange& change);
+  void uploadBounds();
+
+  struct Bounds
+  {
+    QVector3D min;
+    QVector3D max;
+  };
+
+  std::shared_ptr<ui::IModel> model_;
+  std::vector<BrickInstance> instances_;
+
+  // only ever grows, which keeps it conservative when bricks move away or are removed
+  std::optional<Bounds> bounds_;
+  bool boundsGrew_{};
+
+  Qt3DRender::QBuffer* instanceBuffer_;
+  Qt3DRender::QBuffer* boundsBuffer_;
+  std::vector<Qt3DRender::QAttribute*> instanceAttributes_;
+  Qt3DRender::QGeometryRenderer* renderer_;
+};
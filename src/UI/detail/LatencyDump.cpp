@@ -0,0 +1,61 @@
+#include "LatencyDump.hpp"
+
+#include <array>
+#include <iostream>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+  constexpr auto stageNames = std::array<const char*, latencyStageCount>{
+    "handled",
+    "flushed",
+    "synced",
+    "presented",
+    "total",
+  };
+
+  QJsonObject describeStage(const LatencyTracker& latency, LatencyStage stage)
+  {
+    const auto summary = latency.summary(stage);
+
+    auto buckets = QJsonArray();
+    const auto& histogram = latency.histogram(stage);
+    for(auto i = std::size_t{0}; i < histogram.size(); ++i)
+    {
+      auto bucket = QJsonObject{{QStringLiteral("count"), static_cast<double>(histogram[i])}};
+      if(i < LatencyTracker::bucketBounds.size()) bucket[QStringLiteral("upTo")] = LatencyTracker::bucketBounds[i];
+      buckets.append(bucket);
+    }
+
+    auto window = QJsonArray();
+    for(const auto sample : latency.window(stage)) window.append(sample);
+
+    return QJsonObject{{QStringLiteral("count"), static_cast<double>(summary.count)},
+                       {QStringLiteral("p50"), summary.p50},
+                       {QStringLiteral("p99"), summary.p99},
+                       {QStringLiteral("max"), summary.max},
+                       {QStringLiteral("histogram"), buckets},
+                       {QStringLiteral("window"), window}};
+  }
+} // namespace
+
+bool writeLatencyDump(const QString& path, const LatencyTracker& latency)
+{
+  auto stages = QJsonObject();
+  for(auto i = std::size_t{0}; i < latencyStageCount; ++i)
+    stages[QString::fromLatin1(stageNames[i])] = describeStage(latency, static_cast<LatencyStage>(i));
+
+  auto file = QFile(path);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    std::cerr << "cannot write " << path.toStdString() << ": " << file.errorString().toStdString() << '\n';
+    return false;
+  }
+
+  file.write(QJsonDocument(QJsonObject{{QStringLiteral("milliseconds"), stages}}).toJson(QJsonDocument::Indented));
+  return true;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <QString>
+
+#include "LatencyTracker.hpp"
+
+// Writes summary, histogram and latest window of every stage as JSON, for plotting outside the app.
+bool writeLatencyDump(const QString& path, const LatencyTracker& latency);
@@ -0,0 +1,176 @@
+#include "LatencyTracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Statistics/Percentile.hpp"
+
+double LatencyTracker::now()
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyTracker::inputArrived(double time)
+{
+  auto event = InFlight();
+  event.arrived = time;
+  inFlight_.push_back(event);
+}
+
+void LatencyTracker::inputHandled(double time, bool changedModel)
+{
+  if(inFlight_.empty() || inFlight_.back().reached != Progress::Arrived) return;
+
+  if(changedModel)
+  {
+    inFlight_.back().handled = time;
+    inFlight_.back().reached = Progress::Handled;
+  }
+  else
+  {
+    inFlight_.pop_back();
+  }
+}
+
+void LatencyTracker::flushed(double time)
+{
+  for(auto& event : inFlight_)
+  {
+    if(event.reached != Progress::Handled) continue;
+
+    event.flushed = time;
+    event.reached = Progress::Flushed;
+  }
+}
+
+void LatencyTracker::synced(double time)
+{
+  for(auto& event : inFlight_)
+  {
+    if(event.reached != Progress::Flushed) continue;
+
+    event.synced = time;
+    event.reached = Progress::Synced;
+  }
+}
+
+void LatencyTracker::frameStarted(double time)
+{
+  for(auto& event : inFlight_)
+  {
+    if(event.reached != Progress::Synced) continue;
+
+    record(LatencyStage::Handled, event.handled - event.arrived);
+    record(LatencyStage::Flushed, event.flushed - event.handled);
+    record(LatencyStage::Synced, event.synced - event.flushed);
+    record(LatencyStage::Presented, time - event.synced);
+    record(LatencyStage::Total, time - event.arrived);
+  }
+
+  inFlight_.erase(std::remove_if(inFlight_.begin(),
+                                 inFlight_.end(),
+                                 [](const InFlight& event) { return event.reached == Progress::Synced; }),
+                  inFlight_.end());
+}
+
+LatencySummary LatencyTracker::summary(LatencyStage stage) const
+{
+  const auto& samples = samples_[static_cast<std::size_t>(stage)];
+  if(samples.window.empty()) return {};
+
+  auto sorted = samples.window;
+  std::sort(sorted.begin(), sorted.end());
+  return {samples.count, statistics::percentile(sorted, 0.5), statistics::percentile(sorted, 0.99), samples.max};
+}
+
+const LatencyTracker::Histogram& LatencyTracker::histogram(LatencyStage stage) const
+{
+  return samples_[static_cast<std::size_t>(stage)].histogram;
+}
+
+std::vector<double> LatencyTracker::window(LatencyStage stage) const
+{
+  const auto& samples = samples_[static_cast<std::size_t>(stage)];
+  if(samples.window.size() < windowSize_) return samples.window;
+
+  const auto oldest = samples.window.begin() + static_cast<std::ptrdiff_t>(samples.next);
+  auto ordered = std::vector<double>(oldest, samples.window.end());
+  ordered.insert(ordered.end(), samples.window.begin(), oldest);
+  return ordered;
+}
+
+void LatencyTracker::record(LatencyStage stage, double milliseconds)
+{
+  auto& samples = samples_[static_cast<std::size_t>(stage)];
+
+  if(samples.window.size() < windowSize_)
+    samples.window.push_back(milliseconds);
+  else
+    samples.window[samples.next] = milliseconds;
+  samples.next = (samples.next + 1) % windowSize_;
+
+  ++samples.count;
+  samples.max = std::max(samples.max, milliseconds);
+
+  const auto bucket = std::lower_bound(bucketBounds.begin(), bucketBounds.end(), milliseconds) - bucketBounds.begin();
+  ++samples.histogram[static_cast<std::size_t>(bucket)];
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Drag latency is measured until the frame that picks up the sync")
+{
+  auto tracker = LatencyTracker();
+
+  // two moves within one frame, and one that stays in its cell
+  tracker.inputArrived(0.0);
+  tracker.inputHandled(1.0, true);
+  tracker.inputArrived(5.0);
+  tracker.inputHandled(5.5, true);
+  tracker.inputArrived(6.0);
+  tracker.inputHandled(6.5, false);
+
+  tracker.flushed(10.0);
+  tracker.frameStarted(11.0);
+  REQUIRE(tracker.summary(LatencyStage::Total).count == 0);
+
+  tracker.synced(12.0);
+  tracker.frameStarted(32.0);
+  REQUIRE(tracker.summary(LatencyStage::Total).count == 2);
+  REQUIRE(tracker.summary(LatencyStage::Total).max == 32.0);
+  REQUIRE(tracker.summary(LatencyStage::Total).p50 == 27.0);
+  REQUIRE(tracker.summary(LatencyStage::Handled).max == 1.0);
+  REQUIRE(tracker.summary(LatencyStage::Flushed).p50 == 4.5);
+  REQUIRE(tracker.summary(LatencyStage::Synced).p99 == 2.0);
+  REQUIRE(tracker.summary(LatencyStage::Presented).p50 == 20.0);
+
+  // 27 and 32 ms both fall into the bucket up to 32 ms
+  REQUIRE(tracker.histogram(LatencyStage::Total)[5] == 2);
+
+  // events not flushed yet wait for the next flush
+  tracker.inputArrived(40.0);
+  tracker.inputHandled(41.0, true);
+  tracker.synced(42.0);
+  tracker.frameStarted(48.0);
+  tracker.frameStarted(64.0);
+  REQUIRE(tracker.summary(LatencyStage::Total).count == 2);
+}
+
+TEST_CASE("Latency percentiles cover the latest window")
+{
+  auto tracker = LatencyTracker(4);
+  for(auto i = 1; i <= 6; ++i)
+  {
+    const auto start = 100.0 * i;
+    tracker.inputArrived(start);
+    tracker.inputHandled(start, true);
+    tracker.flushed(start);
+    tracker.synced(start);
+    tracker.frameStarted(start + i);
+  }
+
+  REQUIRE(tracker.window(LatencyStage::Total) == std::vector<double>{3.0, 4.0, 5.0, 6.0});
+  REQUIRE(tracker.summary(LatencyStage::Total).count == 6);
+  REQUIRE(tracker.summary(LatencyStage::Total).p50 == 4.0);
+  REQUIRE(tracker.summary(LatencyStage::Total).max == 6.0);
+}
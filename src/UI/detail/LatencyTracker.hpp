@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Stages a drag event passes until the moved brick is on screen.
+enum class LatencyStage : std::size_t
+{
+  Handled,   // input arrived until the model moved the brick
+  Flushed,   // until the model reported the change, which waits for the frame pacing
+  Synced,    // until the scene graph held the new transform
+  Presented, // until the frame that picks up the transform started
+  Total,     // input to photon: the sum of the above
+};
+
+constexpr auto latencyStageCount = static_cast<std::size_t>(LatencyStage::Total) + 1;
+
+struct LatencySummary
+{
+  std::size_t count{};
+  double p50{};
+  double p99{};
+  double max{};
+};
+
+// Follows drag events from input to screen. Times are in milliseconds on a monotonic clock, see now(). Events whose
+// move changed nothing never reach the screen and are dropped. Percentiles cover the latest window of events, the
+// histograms and maxima every event since startup.
+class LatencyTracker
+{
+public:
+  // upper bounds of the histogram buckets in milliseconds; the last bucket takes everything above
+  static constexpr auto bucketBounds = std::array<double, 10>{1, 2, 4, 8, 16, 32, 64, 128, 256, 512};
+  using Histogram = std::array<std::size_t, bucketBounds.size() + 1>;
+
+  static double now();
+
+  void inputArrived(double time);
+  void inputHandled(double time, bool changedModel);
+  void flushed(double time);
+  void synced(double time);
+  // Call at every frame. The first frame after the sync picks up the transform, which completes the event.
+  void frameStarted(double time);
+
+  LatencySummary summary(LatencyStage stage) const;
+  const Histogram& histogram(LatencyStage stage) const;
+  // latest samples, oldest first
+  std::vector<double> window(LatencyStage stage) const;
+
+  // Ctor
+public:
+  explicit LatencyTracker(std::size_t windowSize = 4096) : windowSize_(windowSize) {}
+
+private:
+  enum class Progress
+  {
+    Arrived,
+    Handled,
+    Flushed,
+    Synced,
+  };
+
+  struct InFlight
+  {
+    double arrived{};
+    double handled{};
+    double flushed{};
+    double synced{};
+    Progress reached{};
+  };
+
+  struct Samples
+  {
+    std::vector<double> window; // ring buffer
+    std::size_t next{};
+    std::size_t count{};
+    double max{};
+    Histogram histogram{};
+  };
+
+  void record(LatencyStage stage, double milliseconds);
+
+  std::size_t windowSize_;
+  std::vector<InFlight> inFlight_;
+  std::array<Samples, latencyStageCount> samples_;
+};
@@ -0,0 +1,78 @@
+#include "LevelOfDetail.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // distance at which tier gives way to the next coarser one
+  float coarserFrom(LodTier tier, const LodThresholds& thresholds)
+  {
+    return tier == LodTier::Full ? thresholds.unlitFrom : thresholds.impostorFrom;
+  }
+
+  LodTier coarser(LodTier tier)
+  {
+    return tier == LodTier::Full ? LodTier::Unlit : LodTier::Impostor;
+  }
+
+  LodTier finer(LodTier tier)
+  {
+    return tier == LodTier::Impostor ? LodTier::Unlit : LodTier::Full;
+  }
+} // namespace
+
+LodTier lodTierFor(LodTier current, float distance, const LodThresholds& thresholds)
+{
+  auto tier = current;
+  while(tier != LodTier::Impostor && distance > coarserFrom(tier, thresholds) + thresholds.hysteresis)
+  {
+    tier = coarser(tier);
+  }
+  while(tier != LodTier::Full && distance < coarserFrom(finer(tier), thresholds) - thresholds.hysteresis)
+  {
+    tier = finer(tier);
+  }
+  return tier;
+}
+
+float distanceToBox(const QVector3D& point, const QVector3D& min, const QVector3D& max)
+{
+  auto squared = 0.0f;
+  for(auto axis = 0; axis < 3; ++axis)
+  {
+    const auto outside = std::max({min[axis] - point[axis], 0.0f, point[axis] - max[axis]});
+    squared += outside * outside;
+  }
+  return std::sqrt(squared);
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("LOD tiers switch with hysteresis")
+{
+  const auto thresholds = LodThresholds{40.0f, 90.0f, 5.0f};
+
+  REQUIRE(lodTierFor(LodTier::Full, 44.0f, thresholds) == LodTier::Full);
+  REQUIRE(lodTierFor(LodTier::Full, 46.0f, thresholds) == LodTier::Unlit);
+  REQUIRE(lodTierFor(LodTier::Unlit, 36.0f, thresholds) == LodTier::Unlit);
+  REQUIRE(lodTierFor(LodTier::Unlit, 34.0f, thresholds) == LodTier::Full);
+
+  REQUIRE(lodTierFor(LodTier::Unlit, 94.0f, thresholds) == LodTier::Unlit);
+  REQUIRE(lodTierFor(LodTier::Unlit, 96.0f, thresholds) == LodTier::Impostor);
+  REQUIRE(lodTierFor(LodTier::Impostor, 86.0f, thresholds) == LodTier::Impostor);
+  REQUIRE(lodTierFor(LodTier::Impostor, 84.0f, thresholds) == LodTier::Unlit);
+
+  // big jumps skip tiers
+  REQUIRE(lodTierFor(LodTier::Full, 500.0f, thresholds) == LodTier::Impostor);
+  REQUIRE(lodTierFor(LodTier::Impostor, 0.0f, thresholds) == LodTier::Full);
+}
+
+TEST_CASE("distanceToBox")
+{
+  const auto min = QVector3D{0.0f, 0.0f, 0.0f};
+  const auto max = QVector3D{2.0f, 1.0f, 2.0f};
+  REQUIRE(distanceToBox({1.0f, 0.5f, 1.0f}, min, max) == 0.0f);
+  REQUIRE(distanceToBox({5.0f, 0.5f, 1.0f}, min, max) == 3.0f);
+  REQUIRE(distanceToBox({-3.0f, 5.0f, 1.0f}, min, max) == 5.0f);
+}
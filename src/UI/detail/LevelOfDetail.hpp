@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include <QVector3D>
+
+enum class LodTier : std::uint8_t
+{
+  Full,     // every brick with its lit mesh
+  Unlit,    // every brick with a flat, unlit material
+  Impostor, // one box for the whole chunk
+};
+
+// Distances from the camera at which chunks switch tiers. A chunk only switches once it is hysteresis past the
+// threshold, so chunks near a threshold do not flicker between tiers while the camera moves.
+struct LodThresholds
+{
+  float unlitFrom{40.0f};
+  float impostorFrom{90.0f};
+  float hysteresis{5.0f};
+};
+
+LodTier lodTierFor(LodTier current, float distance, const LodThresholds& thresholds);
+
+// 0 for points inside the box
+float distanceToBox(const QVector3D& point, const QVector3D& min, const QVector3D& max);
@@ -0,0 +1,74 @@
+#include "SceneSync.hpp"
+
+#include <cassert>
+
+#include "BrickRotation.hpp"
+#include "Tracing/Tracing.hpp"
+
+SceneSync::SceneSync(Qt3DCore::QEntity* rootEntity,
+                     std::shared_ptr<ui::IModel> model,
+                     std::shared_ptr<BrickResources> resources,
+                     BrickLook look) :
+  rootEntity_(rootEntity),
+  model_(std::move(model)),
+  resources_(std::move(resources)),
+  look_(std::move(look)),
+  entities_(std::make_shared<std::vector<Qt3DCore::QEntity*>>())
+{
+  for(const auto handle : model_->entities()) insert(handle);
+}
+
+void SceneSync::apply(const std::vector<ui::EntityChange>& changes)
+{
+  TRACE_ZONE("scene", "sync");
+  TRACE_COUNTER("synced bricks", changes.size());
+  for(const auto& change : changes)
+  {
+    switch(change.kind)
+    {
+    case ui::ChangeKind::Inserted: insert(change.handle); break;
+    case ui::ChangeKind::Updated: update(change.handle); break;
+    case ui::ChangeKind::Removed: remove(change.handle); break;
+    }
+  }
+}
+
+void SceneSync::insert(ui::EntityHandle handle)
+{
+  if(handle >= entities_->size())
+  {
+    entities_->resize(handle + 1);
+    transforms_.resize(handle + 1);
+  }
+  assert(!(*entities_)[handle]);
+
+  auto* entity = new Qt3DCore::QEntity(rootEntity_);
+  auto* transform = new Qt3DCore::QTransform();
+  entity->addComponent(transform);
+  entity->addComponent(resources_->mesh(look_.extents));
+  entity->addComponent(resources_->material(look_.color));
+
+  (*entities_)[handle] = entity;
+  transforms_[handle] = transform;
+  update(handle);
+}
+
+void SceneSync::update(ui::EntityHandle handle)
+{
+  assert(handle < transforms_.size() && transforms_[handle]);
+
+  // setMatrix() would decompose the matrix again; setting both parts directly only takes the table lookup
+  auto* transform = transforms_[handle];
+  transform->setTranslation(model_->position(handle));
+  transform->setRotation(brickRotation(model_->quarterTurns(handle)));
+}
+
+void SceneSync::remove(ui::EntityHandle handle)
+{
+  assert(handle < entities_->size() && (*entities_)[handle]);
+
+  // the shared mesh and material belong to the resources, only the entity and its transform go
+  delete (*entities_)[handle];
+  (*entities_)[handle] = nullptr;
+  transforms_[handle] = nullptr;
+}
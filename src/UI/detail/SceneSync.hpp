@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <Qt3DCore/QTransform>
+#include <Qt3DCore/qentity.h>
+
+#include "BrickResources.hpp"
+#include "IModel.hpp"
+
+// Keeps one entity per brick in step with the model. Applies a batch of changes with the least scene graph work:
+// inserted bricks get a new entity, updated ones only a new transform, and removed ones lose their entity. Costs
+// O(changes), whatever the size of the scene.
+class SceneSync
+{
+public:
+  void apply(const std::vector<ui::EntityChange>& changes);
+
+  // indexed by handle, null where there is no brick
+  std::shared_ptr<std::vector<Qt3DCore::QEntity*>> entities() const
+  {
+    return entities_;
+  }
+
+  // Ctor
+public:
+  // creates the entities of the bricks the model already holds
+  SceneSync(Qt3DCore::QEntity* rootEntity,
+            std::shared_ptr<ui::IModel> model,
+            std::shared_ptr<BrickResources> resources,
+            BrickLook look);
+
+private:
+  void insert(ui::EntityHandle handle);
+  void update(ui::EntityHandle handle);
+  void remove(ui::EntityHandle handle);
+
+  Qt3DCore::QEntity* rootEntity_;
+  std::shared_ptr<ui::IModel> model_;
+  std::shared_ptr<BrickResources> resources_;
+  BrickLook look_;
+
+  std::shared_ptr<std::vector<Qt3DCore::QEntity*>> entities_;
+  std::vector<Qt3DCore::QTransform*> transforms_;
+};
@@ -7,7 +7,7 @@
 
 #include <QtGui/QScreen>
 #include <QtWidgets/QApplication>
-#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QWidget>
 
 #include <Qt3DRender/qpointlight.h>
@@ -64,17 +64,22 @@ namespace
   }
 } // namespace
 
-SceneWidget::SceneWidget() : rootEntity_(new Qt3DCore::QEntity())
+SceneWidget::SceneWidget() : rootEntity_(new Qt3DCore::QEntity()), view_(make3DView()), stats_(new QLabel())
 {
   setWindowTitle(QStringLiteral("Move the Brick"));
 
-  auto* view = make3DView();
-  view->setRootEntity(rootEntity_);
-  view->renderSettings();
+  view_->setRootEntity(rootEntity_);
+  view_->renderSettings();
 
-  auto* camera = makeCamera(view);
+  auto* camera = makeCamera(view_);
   addPointLight(rootEntity_, camera->position());
 
-  QHBoxLayout* hLayout = new QHBoxLayout(this);
-  hLayout->addWidget(containerize(view), 1);
+  QVBoxLayout* vLayout = new QVBoxLayout(this);
+  vLayout->addWidget(containerize(view_), 1);
+  vLayout->addWidget(stats_);
+}
+
+void SceneWidget::showStats(const QString& stats)
+{
+  stats_->setText(stats);
 }
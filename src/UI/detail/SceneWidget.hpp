@@ -1,8 +1,14 @@
 #pragma once
 
 #include <QEntity>
+#include <QLabel>
 #include <QWidget>
 
+namespace Qt3DExtras
+{
+  class Qt3DWindow;
+}
+
 class SceneWidget : public QWidget
 {
 public:
@@ -13,6 +19,16 @@ public:
     return rootEntity_;
   }
 
+  Qt3DExtras::Qt3DWindow* view()
+  {
+    return view_;
+  }
+
+  // one line of diagnostics below the scene
+  void showStats(const QString& stats);
+
 private:
   Qt3DCore::QEntity* rootEntity_;
+  Qt3DExtras::Qt3DWindow* view_;
+  QLabel* stats_;
 };
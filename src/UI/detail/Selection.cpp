@@ -0,0 +1,56 @@
+#include "Selection.hpp"
+
+void Selection::press(std::optional<ui::EntityHandle> hit)
+{
+  selected_ = hit;
+}
+
+void Selection::hover(const QPoint& pointer)
+{
+  pointer_ = pointer;
+}
+
+std::optional<ui::EntityHandle> Selection::selected() const
+{
+  return selected_;
+}
+
+std::optional<ui::EntityHandle> Selection::target(const Pick& pick) const
+{
+  if(selected_ || !pointer_) return selected_;
+  return pick(*pointer_);
+}
+
+#include <doctest/doctest.hpp>
+
+TEST_CASE("Selection")
+{
+  const auto first = ui::EntityHandle{1};
+  const auto second = ui::EntityHandle{2};
+  const auto pick = [&](const QPoint& pointer) -> std::optional<ui::EntityHandle> {
+    if(pointer == QPoint(10, 10)) return first;
+    if(pointer == QPoint(20, 20)) return second;
+    return std::nullopt;
+  };
+
+  auto selection = Selection();
+  REQUIRE(!selection.target(pick));
+
+  // hovering targets the brick under the pointer
+  selection.hover({20, 20});
+  REQUIRE(selection.target(pick) == second);
+
+  // a pressed brick stays the target wherever the pointer goes
+  selection.press(first);
+  selection.hover({20, 20});
+  REQUIRE(selection.selected() == first);
+  REQUIRE(selection.target(pick) == first);
+
+  // pressing empty space drops it, so hovering targets again
+  selection.press(std::nullopt);
+  REQUIRE(!selection.selected());
+  REQUIRE(selection.target(pick) == second);
+
+  selection.hover({0, 0});
+  REQUIRE(!selection.target(pick));
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include <QPoint>
+
+#include "IModel.hpp"
+
+// Which brick rotations act on: the one last pressed, else the one under the pointer. A press that hits no brick
+// clears the selection. The hovered brick is picked only when asked for, so plain pointer moves cast no rays.
+class Selection
+{
+public:
+  using Pick = std::function<std::optional<ui::EntityHandle>(const QPoint&)>;
+
+  // the brick hit by a press, if any
+  void press(std::optional<ui::EntityHandle> hit);
+  void hover(const QPoint& pointer);
+
+  std::optional<ui::EntityHandle> selected() const;
+  std::optional<ui::EntityHandle> target(const Pick& pick) const;
+
+private:
+  std::optional<ui::EntityHandle> selected_;
+  std::optional<QPoint> pointer_;
+};
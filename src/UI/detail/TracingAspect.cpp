@@ -0,0 +1,35 @@
+#include "TracingAspect.hpp"
+
+#include <Qt3DCore/QAspectJob>
+
+#include "Tracing/Tracing.hpp"
+
+namespace
+{
+  // once per thread, as naming takes the thread's buffer lock
+  void nameThreadOnce(const char* name)
+  {
+    thread_local auto named = false;
+    if(named) return;
+
+    tracing::nameThread(name);
+    named = true;
+  }
+
+  class FrameJob : public Qt3DCore::QAspectJob
+  {
+  public:
+    void run() override
+    {
+      nameThreadOnce("Qt3D job pool");
+      TRACE_ZONE("qt3d", "frame job");
+    }
+  };
+} // namespace
+
+QVector<Qt3DCore::QAspectJobPtr> TracingAspect::jobsToExecute(qint64 /*time*/)
+{
+  nameThreadOnce("Qt3D aspects");
+  TRACE_ZONE("qt3d", "schedule frame");
+  return {Qt3DCore::QAspectJobPtr(new FrameJob())};
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Qt3DCore/QAbstractAspect>
+
+// Marks each Qt3D frame on Qt3D's own threads: jobsToExecute() runs where the aspect manager does, the job it returns
+// on Qt3D's job pool. Qt3D's built-in jobs cannot be instrumented, so these markers put the frames of the other aspects
+// on the same timeline as the main thread.
+class TracingAspect : public Qt3DCore::QAbstractAspect
+{
+public:
+  using QAbstractAspect::QAbstractAspect;
+
+private:
+  QVector<Qt3DCore::QAspectJobPtr> jobsToExecute(qint64 time) override;
+};
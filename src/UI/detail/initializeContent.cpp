@@ -1,103 +1,175 @@
 #include "initializeContent.hpp"
 
-#include <Qt3DCore/QTransform>
+#include <functional>
+#include <utility>
 
-#include <Qt3DExtras/QCuboidMesh>
-#include <Qt3DExtras/QPhongMaterial>
+#include <Qt3DExtras/qt3dwindow.h>
 
-#include <Qt3DInput/QMouseHandler>
+#include <Qt3DLogic/QFrameAction>
 
-#include <Qt3DRender/QObjectPicker>
-#include <Qt3DRender/QPickEvent>
+#include <Qt3DRender/QCamera>
 
-#include <QMouseDevice>
+#include <QStringList>
+
+#include "BrickResources.hpp"
+#include "ChunkCuller.hpp"
+#include "FrameScheduler.hpp"
+#include "InputDispatcher.hpp"
+#include "InstancedBricks.hpp"
+#include "SceneSync.hpp"
+#include "Tracing/Tracing.hpp"
 
 namespace
 {
-  auto makeMesh()
+  const auto brickExtents = QVector3D(2.0f, 0.72f, 1.0f);
+  const auto brickColor = QColor(QRgb(0xFFF03A));
+
+  // The sync creates and deletes the entities the culler works on, so it has to see each batch first.
+  void syncOnBatchChange(std::shared_ptr<ui::IModel> model,
+                         std::shared_ptr<SceneSync> sync,
+                         std::shared_ptr<ChunkCuller> culler,
+                         std::shared_ptr<LatencyTracker> latency,
+                         QObject* context)
   {
-    auto* mesh = new Qt3DExtras::QCuboidMesh();
-    return mesh;
+    QObject::connect(model.get(),
+                     &ui::IModel::entitiesChanged,
+                     context,
+                     [sync, culler, latency](const std::vector<ui::EntityChange>& changes) {
+                       latency->flushed(LatencyTracker::now());
+                       sync->apply(changes);
+                       latency->synced(LatencyTracker::now());
+                       culler->update(changes);
+                     });
   }
 
-  auto makeTransform()
+  void trackLatencyPerFrame(Qt3DCore::QEntity* rootEntity, std::shared_ptr<LatencyTracker> latency)
   {
-    Qt3DCore::QTransform* transform = new Qt3DCore::QTransform();
-    transform->setScale3D({2.0f, 0.72f, 1.0f});
-    return transform;
-  }
-
-  auto makeMaterial()
-  {
-    Qt3DExtras::QPhongMaterial* material = new Qt3DExtras::QPhongMaterial();
-    material->setDiffuse(QColor(QRgb(0xFFF03A)));
-    return material;
+    auto* frameAction = new Qt3DLogic::QFrameAction();
+    QObject::connect(frameAction, &Qt3DLogic::QFrameAction::triggered, rootEntity, [latency](float /*dt*/) {
+      latency->frameStarted(LatencyTracker::now());
+    });
+    rootEntity->addComponent(frameAction);
   }
 
-  auto makeTranslationInteractionComponent(std::shared_ptr<ui::IModelEntity> model)
+  QString describeLatency(const LatencyTracker& latency)
   {
-    auto* picker = new Qt3DRender::QObjectPicker();
-    picker->setEnabled(true);
-    picker->setDragEnabled(true);
-
-    QObject::connect(picker, &Qt3DRender::QObjectPicker::moved, [model](Qt3DRender::QPickEvent* event) {
-      model->moveTo({event->worldIntersection().x(), model->position().y(), event->worldIntersection().z()});
-    });
-
-    QObject::connect(picker, &Qt3DRender::QObjectPicker::pressed, [model](Qt3DRender::QPickEvent* event) {
-      qDebug() << "pressed at: " << event->worldIntersection() << "; local: " << event->localIntersection();
-    });
-
-    return picker;
+    const auto total = latency.summary(LatencyStage::Total);
+    return QStringLiteral("drag latency p50 %1 / p99 %2 / max %3 ms")
+      .arg(total.p50, 0, 'f', 1)
+      .arg(total.p99, 0, 'f', 1)
+      .arg(total.max, 0, 'f', 1);
   }
 
-  auto makeRotationInteractionComponent(Qt3DInput::QMouseDevice* mouseDevice, std::shared_ptr<ui::IModelEntity> model)
+  QString describeDutyCycle(const FrameScheduler& scheduler)
   {
-    auto mouseHandler = new Qt3DInput::QMouseHandler();
-    mouseHandler->setSourceDevice(mouseDevice);
-
-    QObject::connect(mouseHandler, &Qt3DInput::QMouseHandler::wheel, [model](Qt3DInput::QWheelEvent* /*event*/) {
-      model->rotate();
-    });
-
-    return mouseHandler;
+    return QStringLiteral("active %1% | dragging %2% | idle %3%")
+      .arg(100.0 * scheduler.share(FramePhase::Active), 0, 'f', 1)
+      .arg(100.0 * scheduler.share(FramePhase::Dragging), 0, 'f', 1)
+      .arg(100.0 * scheduler.share(FramePhase::Idle), 0, 'f', 1);
   }
 
-  void loadTransformFromModel(Qt3DCore::QTransform* transform, std::shared_ptr<ui::IModelEntity> model)
+  // Shows the stats twice a second, as updating the label costs more than gathering them. The label, if any, comes
+  // first, followed by the frame pacing and the drag latency.
+  void reportTwiceASecond(SceneWidget& scene,
+                          const FrameScheduler* scheduler,
+                          std::shared_ptr<LatencyTracker> latency,
+                          std::function<QString()> label)
   {
-    transform->setTranslation(model->position());
-    transform->setRotationY(model->yRotation());
+    constexpr auto reportInterval = 0.5f;
+
+    auto* frameAction = new Qt3DLogic::QFrameAction();
+    QObject::connect(frameAction,
+                     &Qt3DLogic::QFrameAction::triggered,
+                     &scene,
+                     [&scene, scheduler, latency, label = std::move(label), sinceReport = 0.0f](float dt) mutable {
+                       sinceReport += dt;
+                       if(sinceReport < reportInterval) return;
+                       sinceReport = 0.0f;
+
+                       auto parts = QStringList{describeDutyCycle(*scheduler), describeLatency(*latency)};
+                       if(label) parts.prepend(label());
+                       scene.showStats(parts.join(QStringLiteral(" | ")));
+                     });
+    scene.rootEntity()->addComponent(frameAction);
   }
 
-  void updateOnModelChange(std::shared_ptr<ui::IModelEntity> model, Qt3DCore::QTransform* transform)
+  // An idle scene has nothing to cull, as camera moves and model changes wake the scheduler.
+  void cullOncePerFrame(SceneWidget& scene,
+                        std::shared_ptr<ChunkCuller> culler,
+                        const FrameScheduler* scheduler,
+                        std::shared_ptr<LatencyTracker> latency)
   {
-    QObject::connect(model.get(), &ui::IModelEntity::dataChanged, transform, [model, transform]() {
-      loadTransformFromModel(transform, model);
+    const auto stats = std::make_shared<CullingStats>();
+
+    auto* frameAction = new Qt3DLogic::QFrameAction();
+    auto* camera = scene.view()->camera();
+    QObject::connect(frameAction,
+                     &Qt3DLogic::QFrameAction::triggered,
+                     &scene,
+                     [culler, camera, scheduler, stats](float /*dt*/) {
+                       if(scheduler->phase() == FramePhase::Idle) return;
+
+                       TRACE_ZONE("scene", "cull");
+                       *stats = culler->cull(camera->projectionMatrix() * camera->viewMatrix(), camera->position());
+                     });
+    scene.rootEntity()->addComponent(frameAction);
+
+    reportTwiceASecond(scene, scheduler, latency, [stats] {
+      return QStringLiteral("chunks %1/%2 (unlit %3, impostor %4) | bricks %5/%6 | culling %7 ms")
+        .arg(stats->visibleChunks)
+        .arg(stats->chunks)
+        .arg(stats->unlitChunks)
+        .arg(stats->impostorChunks)
+        .arg(stats->visibleBricks)
+        .arg(stats->bricks)
+        .arg(stats->milliseconds, 0, 'f', 3);
     });
   }
 
-  void addBrickTo(Qt3DCore::QEntity* rootEntity,
-                 std::shared_ptr<ui::IModelEntity> model,
-                 Qt3DInput::QMouseDevice* mouseDevice)
+  void initializeInstancedContent(SceneWidget& scene,
+                                  std::shared_ptr<ui::IModel> model,
+                                  const FrameScheduler* scheduler,
+                                  std::shared_ptr<LatencyTracker> latency)
   {
-    auto entity = new Qt3DCore::QEntity(rootEntity);
+    auto bricks = std::make_shared<InstancedBricks>(scene.rootEntity(), model);
+    QObject::connect(model.get(),
+                     &ui::IModel::entitiesChanged,
+                     scene.rootEntity(),
+                     [bricks, latency](const std::vector<ui::EntityChange>& changes) {
+                       latency->flushed(LatencyTracker::now());
+                       bricks->update(changes);
+                       latency->synced(LatencyTracker::now());
+                     });
+
+    reportTwiceASecond(scene, scheduler, latency, {});
+  }
+} // namespace
 
-    auto transform = makeTransform();
-    entity->addComponent(transform);
-    loadTransformFromModel(transform, model);
-    updateOnModelChange(model, transform);
+void initializeContent(SceneWidget& scene,
+                       std::shared_ptr<ui::IModel> model,
+                       BrickRendering rendering,
+                       std::shared_ptr<LatencyTracker> latency)
+{
+  auto* rootEntity = scene.rootEntity();
+  new InputDispatcher(rootEntity, model, scene.view(), latency);
+  trackLatencyPerFrame(rootEntity, latency);
 
-    entity->addComponent(makeTranslationInteractionComponent(model));
-    entity->addComponent(makeRotationInteractionComponent(mouseDevice, model));
+  // the scene is built from the bricks as they are now, so nobody needs to hear about the changes that led there
+  model->flushChanges();
+  const auto* scheduler = new FrameScheduler(rootEntity, model, scene.view());
 
-    entity->addComponent(makeMesh());
-    entity->addComponent(makeMaterial());
+  if(rendering == BrickRendering::Instanced)
+  {
+    initializeInstancedContent(scene, model, scheduler, latency);
+    return;
   }
-} // namespace
 
-void initializeContent(Qt3DCore::QEntity* rootEntity, std::shared_ptr<ui::IModel> model)
-{
-  auto* mouseDevice = new Qt3DInput::QMouseDevice(rootEntity);
+  const auto resources = std::make_shared<BrickResources>(rootEntity);
+
+  const auto look = BrickLook{brickExtents, brickColor};
+  const auto sync = std::make_shared<SceneSync>(rootEntity, model, resources, look);
+  const auto culler = std::make_shared<ChunkCuller>(rootEntity, model, sync->entities(), resources, look);
 
-  addBrickTo(rootEntity, model->get(), mouseDevice);
+  syncOnBatchChange(model, sync, culler, latency, rootEntity);
+  cullOncePerFrame(scene, culler, scheduler, latency);
 }
@@ -1,8 +1,20 @@
 
 #pragma once
 
-#include <Qt3DCore/qentity.h>
+#include <memory>
 
 #include "IModel.hpp"
+#include "LatencyTracker.hpp"
+#include "SceneWidget.hpp"
 
-void initializeContent(Qt3DCore::QEntity* rootEntity, std::shared_ptr<ui::IModel> model);
+enum class BrickRendering
+{
+  EntityPerBrick, // one QEntity per brick, culled by chunk
+  Instanced,      // one instanced draw call for all bricks
+};
+
+// Drag latencies are recorded into latency and shown below the scene.
+void initializeContent(SceneWidget& scene,
+                       std::shared_ptr<ui::IModel> model,
+                       BrickRendering rendering,
+                       std::shared_ptr<LatencyTracker> latency = std::make_shared<LatencyTracker>());